@@ -14,10 +14,10 @@ Agent::Agent(int id, const std::string &firstName, const std::string &lastName,
 }
 
 int Agent::getId() const { return m_id; }
-std::string Agent::getFirstName() const { return m_firstName; }
-std::string Agent::getLastName() const { return m_lastName; }
-std::string Agent::getPhone() const { return m_phone; }
-std::string Agent::getEmail() const { return m_email; }
+const std::string& Agent::getFirstName() const { return m_firstName; }
+const std::string& Agent::getLastName() const { return m_lastName; }
+const std::string& Agent::getPhone() const { return m_phone; }
+const std::string& Agent::getEmail() const { return m_email; }
 Date Agent::getStartDate() const { return m_startDate; }
 Date Agent::getEndDate() const { return m_endDate; }
 
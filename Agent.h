@@ -15,10 +15,10 @@ public:
 
     // Getters
     int getId() const;
-    std::string getFirstName() const;
-    std::string getLastName() const;
-    std::string getPhone() const;
-    std::string getEmail() const;
+    const std::string& getFirstName() const;
+    const std::string& getLastName() const;
+    const std::string& getPhone() const;
+    const std::string& getEmail() const;
     Date getStartDate() const;
     Date getEndDate() const;
 
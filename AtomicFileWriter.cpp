@@ -0,0 +1,71 @@
+#include "AtomicFileWriter.h"
+#include "Exceptions.h"
+#include "FileUtils.h"
+
+AtomicFileWriter::AtomicFileWriter(const std::string &path, size_t bufferSize)
+    : m_path(path), m_tempPath(tempPathFor(path)), m_file(std::fopen(m_tempPath.c_str(), "wb")),
+      m_bufferSize(bufferSize), m_bytesWritten(0)
+{
+    if(!m_file)
+        throw FileOperationException(m_tempPath, "write");
+    m_buffer.reserve(m_bufferSize);
+}
+
+AtomicFileWriter::~AtomicFileWriter() {
+    if(m_file) {
+        // Abandoned before sync(): the live file is untouched, drop the partial copy
+        std::fclose(m_file);
+        std::remove(m_tempPath.c_str());
+    }
+}
+
+std::string AtomicFileWriter::tempPathFor(const std::string &path) {
+    return path + ".tmp";
+}
+
+void AtomicFileWriter::write(std::string_view data) {
+    m_bytesWritten += data.size();
+    if(m_buffer.size() + data.size() > m_bufferSize)
+        flushBuffer();
+    if(data.size() >= m_bufferSize) {
+        if(std::fwrite(data.data(), 1, data.size(), m_file) != data.size())
+            throw FileOperationException(m_tempPath, "write");
+        return;
+    }
+    m_buffer.append(data);
+}
+
+void AtomicFileWriter::write(char c) {
+    ++m_bytesWritten;
+    if(m_buffer.size() >= m_bufferSize)
+        flushBuffer();
+    m_buffer += c;
+}
+
+void AtomicFileWriter::flushBuffer() {
+    if(m_buffer.empty())
+        return;
+    if(std::fwrite(m_buffer.data(), 1, m_buffer.size(), m_file) != m_buffer.size())
+        throw FileOperationException(m_tempPath, "write");
+    m_buffer.clear();
+}
+
+void AtomicFileWriter::sync() {
+    if(!m_file)
+        return;
+    flushBuffer();
+    bool synced = flushAndSync(m_file);
+    bool closed = std::fclose(m_file) == 0;
+    m_file = nullptr;
+    if(!synced || !closed) {
+        std::remove(m_tempPath.c_str());
+        throw FileOperationException(m_tempPath, "sync");
+    }
+}
+
+void AtomicFileWriter::commit() {
+    sync();
+    if(!replaceFile(m_tempPath, m_path))
+        throw FileOperationException(m_path, "replace");
+    syncParentDirectory(m_path);
+}
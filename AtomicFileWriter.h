@@ -0,0 +1,48 @@
+#ifndef ATOMICFILEWRITER_H
+#define ATOMICFILEWRITER_H
+
+#include <cstddef>
+#include <cstdio>
+#include <string>
+#include <string_view>
+
+// Writes the new contents of 'path' to "<path>.tmp" through a large
+// in-memory buffer, so the live file is never truncated or half-written.
+//
+// sync() flushes and fsyncs the temp file; commit() additionally renames it
+// over 'path'. Several synced files can instead be published together with
+// commitFileGeneration() (FileUtils.h). A temp file that was never synced is
+// removed on destruction.
+class AtomicFileWriter {
+public:
+    explicit AtomicFileWriter(const std::string &path, size_t bufferSize = 1 << 20);
+    ~AtomicFileWriter();
+
+    AtomicFileWriter(const AtomicFileWriter&) = delete;
+    AtomicFileWriter& operator=(const AtomicFileWriter&) = delete;
+
+    void write(std::string_view data);
+    void write(char c);
+
+    // Flush, fsync and close the temp file; throws FileOperationException
+    void sync();
+    // sync() and atomically replace 'path' with the temp file
+    void commit();
+
+    const std::string& path() const { return m_path; }
+    size_t bytesWritten() const { return m_bytesWritten; }
+
+    static std::string tempPathFor(const std::string &path);
+
+private:
+    void flushBuffer();
+
+    std::string m_path;
+    std::string m_tempPath;
+    std::FILE *m_file;
+    std::string m_buffer;
+    size_t m_bufferSize;
+    size_t m_bytesWritten;
+};
+
+#endif // ATOMICFILEWRITER_H
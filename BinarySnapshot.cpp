@@ -0,0 +1,358 @@
+#include "BinarySnapshot.h"
+#include "MappedFile.h"
+#include "AtomicFileWriter.h"
+#include "Exceptions.h"
+#include <array>
+#include <cstring>
+#include <unordered_map>
+
+static const char MAGIC[8] = {'R', 'E', 'C', 'R', 'M', 'S', 'N', 'P'};
+static const size_t HEADER_SIZE = 8 + 4 + 4 + 8 * 4 + 8;
+
+// Fixed record widths (see the field order in the encode/decode functions).
+// A type field is a string reference in version 1 and a single byte since.
+static const size_t STRING_REF_SIZE = 8;
+
+struct RecordSizes {
+    size_t agent, client, property, contract;
+};
+
+static RecordSizes recordSizes(uint32_t version) {
+    size_t type = version == 1 ? STRING_REF_SIZE : 1;
+    return {4 + 4 * STRING_REF_SIZE + 4 + 4,
+            4 + 4 * STRING_REF_SIZE + 1 + 8 + type,
+            4 + 8 + 8 + type + 4 + 4 + STRING_REF_SIZE + 1 + type,
+            4 + 4 + 4 + 4 + 8 + 4 + 4 + type + 1};
+}
+
+static uint32_t loadU32(const char *p) {
+    const unsigned char *b = reinterpret_cast<const unsigned char*>(p);
+    return b[0] | (b[1] << 8) | (b[2] << 16) | (static_cast<uint32_t>(b[3]) << 24);
+}
+
+// Slicing-by-8: eight 256-entry tables let the loop consume 8 bytes per step
+uint32_t BinarySnapshot::crc32(const char *data, size_t size, uint32_t crc) {
+    static const auto tables = [] {
+        std::array<std::array<uint32_t, 256>, 8> t{};
+        for(uint32_t i = 0; i < 256; ++i) {
+            uint32_t c = i;
+            for(int k = 0; k < 8; ++k)
+                c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+            t[0][i] = c;
+        }
+        for(uint32_t i = 0; i < 256; ++i) {
+            for(int k = 1; k < 8; ++k)
+                t[k][i] = (t[k - 1][i] >> 8) ^ t[0][t[k - 1][i] & 0xFF];
+        }
+        return t;
+    }();
+
+    crc = ~crc;
+    while(size >= 8) {
+        uint32_t one = loadU32(data) ^ crc;
+        uint32_t two = loadU32(data + 4);
+        crc = tables[7][one & 0xFF] ^ tables[6][(one >> 8) & 0xFF]
+            ^ tables[5][(one >> 16) & 0xFF] ^ tables[4][one >> 24]
+            ^ tables[3][two & 0xFF] ^ tables[2][(two >> 8) & 0xFF]
+            ^ tables[1][(two >> 16) & 0xFF] ^ tables[0][two >> 24];
+        data += 8;
+        size -= 8;
+    }
+    while(size--) {
+        crc = tables[0][(crc ^ static_cast<unsigned char>(*data++)) & 0xFF] ^ (crc >> 8);
+    }
+    return ~crc;
+}
+
+static int32_t packDate(const Date &date) {
+    if(date.isEmpty())
+        return 0;
+    return date.getYear() * 10000 + date.getMonth() * 100 + date.getDay();
+}
+
+static Date unpackDate(int32_t packed) {
+    if(packed == 0)
+        return Date::emptyDate();
+    return Date(packed / 10000, packed / 100 % 100, packed % 100);
+}
+
+// ------------------------
+// Encoding
+// ------------------------
+namespace {
+
+class Encoder {
+public:
+    void putU8(uint8_t v) { m_out.push_back(static_cast<char>(v)); }
+    void putU32(uint32_t v) {
+        for(int i = 0; i < 4; ++i) putU8(static_cast<uint8_t>(v >> (8 * i)));
+    }
+    void putU64(uint64_t v) {
+        for(int i = 0; i < 8; ++i) putU8(static_cast<uint8_t>(v >> (8 * i)));
+    }
+    void putI32(int32_t v) { putU32(static_cast<uint32_t>(v)); }
+    void putF64(double v) {
+        uint64_t bits;
+        std::memcpy(&bits, &v, sizeof bits);
+        putU64(bits);
+    }
+    // Intern the string in the heap and write its (offset, length) reference
+    void putString(const std::string &value) {
+        auto it = m_interned.find(value);
+        uint32_t offset;
+        if(it != m_interned.end()) {
+            offset = it->second;
+        } else {
+            offset = static_cast<uint32_t>(m_heap.size());
+            m_heap += value;
+            m_interned.emplace(value, offset);
+        }
+        putU32(offset);
+        putU32(static_cast<uint32_t>(value.size()));
+    }
+
+    std::string &bytes() { return m_out; }
+    const std::string &heap() const { return m_heap; }
+
+private:
+    std::string m_out;
+    std::string m_heap;
+    std::unordered_map<std::string, uint32_t> m_interned;
+};
+
+class Decoder {
+public:
+    Decoder(const char *data, size_t size, const char *heap, size_t heapSize)
+        : m_data(data), m_size(size), m_pos(0), m_heap(heap), m_heapSize(heapSize) {}
+
+    uint8_t getU8() { need(1); return static_cast<uint8_t>(m_data[m_pos++]); }
+    uint32_t getU32() {
+        uint32_t v = 0;
+        for(int i = 0; i < 4; ++i) v |= static_cast<uint32_t>(getU8()) << (8 * i);
+        return v;
+    }
+    uint64_t getU64() {
+        uint64_t v = 0;
+        for(int i = 0; i < 8; ++i) v |= static_cast<uint64_t>(getU8()) << (8 * i);
+        return v;
+    }
+    int32_t getI32() { return static_cast<int32_t>(getU32()); }
+    double getF64() {
+        uint64_t bits = getU64();
+        double v;
+        std::memcpy(&v, &bits, sizeof v);
+        return v;
+    }
+    std::string getString() {
+        uint32_t offset = getU32();
+        uint32_t length = getU32();
+        if(static_cast<uint64_t>(offset) + length > m_heapSize)
+            throw CRMException("Snapshot string reference out of range");
+        return std::string(m_heap + offset, length);
+    }
+
+private:
+    const char *m_data;
+    size_t m_size;
+    size_t m_pos;
+    const char *m_heap;
+    size_t m_heapSize;
+
+    void need(size_t n) const {
+        if(m_pos + n > m_size)
+            throw CRMException("Snapshot truncated");
+    }
+};
+
+} // namespace
+
+template <typename E>
+static void encodeType(Encoder &out, E value) {
+    out.putU8(static_cast<uint8_t>(value));
+}
+
+template <typename E>
+static E decodeType(Decoder &in, uint32_t version) {
+    E value;
+    bool known = version == 1 ? fromString(in.getString(), value)
+                              : !toString(value = static_cast<E>(in.getU8())).empty();
+    if(!known)
+        throw CRMException("Snapshot holds an unknown type value");
+    return value;
+}
+
+static void encodeAgent(Encoder &out, const Agent &a) {
+    out.putI32(a.getId());
+    out.putString(a.getFirstName());
+    out.putString(a.getLastName());
+    out.putString(a.getPhone());
+    out.putString(a.getEmail());
+    out.putI32(packDate(a.getStartDate()));
+    out.putI32(packDate(a.getEndDate()));
+}
+
+static Agent decodeAgent(Decoder &in) {
+    Agent a;
+    a.setId(in.getI32());
+    a.setFirstName(in.getString());
+    a.setLastName(in.getString());
+    a.setPhone(in.getString());
+    a.setEmail(in.getString());
+    a.setStartDate(unpackDate(in.getI32()));
+    a.setEndDate(unpackDate(in.getI32()));
+    return a;
+}
+
+static void encodeClient(Encoder &out, const Client &c) {
+    out.putI32(c.getId());
+    out.putString(c.getFirstName());
+    out.putString(c.getLastName());
+    out.putString(c.getPhone());
+    out.putString(c.getEmail());
+    out.putU8(c.getIsMarried() ? 1 : 0);
+    out.putF64(c.getBudget());
+    encodeType(out, c.getBudgetType());
+}
+
+static Client decodeClient(Decoder &in, uint32_t version) {
+    Client c;
+    c.setId(in.getI32());
+    c.setFirstName(in.getString());
+    c.setLastName(in.getString());
+    c.setPhone(in.getString());
+    c.setEmail(in.getString());
+    c.setIsMarried(in.getU8() != 0);
+    c.setBudget(in.getF64());
+    c.setBudgetType(decodeType<BudgetType>(in, version));
+    return c;
+}
+
+static void encodeProperty(Encoder &out, const Property &p) {
+    out.putI32(p.getId());
+    out.putF64(p.getSizeSqm());
+    out.putF64(p.getPrice());
+    encodeType(out, p.getPropertyType());
+    out.putI32(p.getBedrooms());
+    out.putI32(p.getBathrooms());
+    out.putString(p.getPlace());
+    out.putU8(p.getAvailability() ? 1 : 0);
+    encodeType(out, p.getListingType());
+}
+
+static Property decodeProperty(Decoder &in, uint32_t version) {
+    Property p;
+    p.setId(in.getI32());
+    p.setSizeSqm(in.getF64());
+    p.setPrice(in.getF64());
+    p.setPropertyType(decodeType<PropertyType>(in, version));
+    p.setBedrooms(in.getI32());
+    p.setBathrooms(in.getI32());
+    p.setPlace(in.getString());
+    p.setAvailability(in.getU8() != 0);
+    p.setListingType(decodeType<ListingType>(in, version));
+    return p;
+}
+
+static void encodeContract(Encoder &out, const Contract &ct) {
+    out.putI32(ct.getId());
+    out.putI32(ct.getPropertyId());
+    out.putI32(ct.getClientId());
+    out.putI32(ct.getAgentId());
+    out.putF64(ct.getPrice());
+    out.putI32(packDate(ct.getStartDate()));
+    out.putI32(packDate(ct.getEndDate()));
+    encodeType(out, ct.getContractType());
+    out.putU8(ct.getIsActive() ? 1 : 0);
+}
+
+static Contract decodeContract(Decoder &in, uint32_t version) {
+    Contract ct;
+    ct.setId(in.getI32());
+    ct.setPropertyId(in.getI32());
+    ct.setClientId(in.getI32());
+    ct.setAgentId(in.getI32());
+    ct.setPrice(in.getF64());
+    ct.setStartDate(unpackDate(in.getI32()));
+    ct.setEndDate(unpackDate(in.getI32()));
+    ct.setContractType(decodeType<ContractType>(in, version));
+    ct.setIsActive(in.getU8() != 0);
+    return ct;
+}
+
+size_t BinarySnapshot::save(const std::string &path,
+                            const std::vector<Agent> &agents, const std::vector<Client> &clients,
+                            const std::vector<Property> &properties, const std::vector<Contract> &contracts) {
+    RecordSizes sizes = recordSizes(VERSION);
+    Encoder records;
+    records.bytes().reserve(agents.size() * sizes.agent + clients.size() * sizes.client
+                            + properties.size() * sizes.property + contracts.size() * sizes.contract);
+    for(const auto &a : agents) encodeAgent(records, a);
+    for(const auto &c : clients) encodeClient(records, c);
+    for(const auto &p : properties) encodeProperty(records, p);
+    for(const auto &ct : contracts) encodeContract(records, ct);
+
+    const std::string &body = records.bytes();
+    const std::string &heap = records.heap();
+    uint32_t checksum = crc32(heap.data(), heap.size(), crc32(body.data(), body.size()));
+
+    Encoder header;
+    header.bytes().append(MAGIC, sizeof MAGIC);
+    header.putU32(VERSION);
+    header.putU32(checksum);
+    header.putU64(agents.size());
+    header.putU64(clients.size());
+    header.putU64(properties.size());
+    header.putU64(contracts.size());
+    header.putU64(heap.size());
+
+    AtomicFileWriter out(path);
+    out.write(header.bytes());
+    out.write(body);
+    out.write(heap);
+    out.commit();
+    return out.bytesWritten();
+}
+
+bool BinarySnapshot::load(const std::string &path,
+                          std::vector<Agent> &agents, std::vector<Client> &clients,
+                          std::vector<Property> &properties, std::vector<Contract> &contracts) {
+    MappedFile file(path);
+    if(!file.isOpen())
+        return false;
+    std::string_view data = file.contents();
+    if(data.size() < HEADER_SIZE || std::memcmp(data.data(), MAGIC, sizeof MAGIC) != 0)
+        throw CRMException("Not a CRM snapshot: " + path);
+
+    Decoder header(data.data() + sizeof MAGIC, HEADER_SIZE - sizeof MAGIC, nullptr, 0);
+    uint32_t version = header.getU32();
+    if(version < 1 || version > VERSION)
+        throw CRMException("Unsupported snapshot version " + std::to_string(version) + " in " + path);
+    uint32_t checksum = header.getU32();
+    uint64_t agentCount = header.getU64();
+    uint64_t clientCount = header.getU64();
+    uint64_t propertyCount = header.getU64();
+    uint64_t contractCount = header.getU64();
+    uint64_t heapSize = header.getU64();
+
+    RecordSizes sizes = recordSizes(version);
+    uint64_t bodySize = agentCount * sizes.agent + clientCount * sizes.client
+                      + propertyCount * sizes.property + contractCount * sizes.contract;
+    if(HEADER_SIZE + bodySize + heapSize != data.size())
+        throw CRMException("Snapshot size mismatch: " + path);
+
+    const char *body = data.data() + HEADER_SIZE;
+    const char *heap = body + bodySize;
+    if(crc32(body, bodySize + heapSize) != checksum)
+        throw CRMException("Snapshot checksum mismatch: " + path);
+
+    Decoder in(body, bodySize, heap, heapSize);
+    agents.reserve(agents.size() + agentCount);
+    for(uint64_t i = 0; i < agentCount; ++i) agents.push_back(decodeAgent(in));
+    clients.reserve(clients.size() + clientCount);
+    for(uint64_t i = 0; i < clientCount; ++i) clients.push_back(decodeClient(in, version));
+    properties.reserve(properties.size() + propertyCount);
+    for(uint64_t i = 0; i < propertyCount; ++i) properties.push_back(decodeProperty(in, version));
+    contracts.reserve(contracts.size() + contractCount);
+    for(uint64_t i = 0; i < contractCount; ++i) contracts.push_back(decodeContract(in, version));
+    return true;
+}
@@ -0,0 +1,44 @@
+#ifndef BINARYSNAPSHOT_H
+#define BINARYSNAPSHOT_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "Agent.h"
+#include "Client.h"
+#include "Property.h"
+#include "Contract.h"
+
+// Versioned binary image of the four CRM collections.
+//
+// Layout (all integers little-endian):
+//   header   magic "RECRMSNP", u32 version, u32 crc32(payload),
+//            u64 agent/client/property/contract counts, u64 string heap size
+//   payload  fixed-width agent, client, property and contract records,
+//            followed by the string heap
+// Strings are (u32 offset, u32 length) references into the heap, identical
+// strings are stored once; dates are packed as yyyymmdd (0 = empty). The
+// property, listing, budget and contract types are one u8 each (their enum
+// value); version 1 files, which held them as strings, are still read.
+class BinarySnapshot {
+public:
+    static const uint32_t VERSION = 2;
+
+    // Returns the number of bytes written. Throws FileOperationException if
+    // the file cannot be written.
+    static size_t save(const std::string &path,
+                     const std::vector<Agent> &agents, const std::vector<Client> &clients,
+                     const std::vector<Property> &properties, const std::vector<Contract> &contracts);
+
+    // Returns false if the file does not exist. Throws CRMException on a bad
+    // magic/version, truncated file or checksum mismatch.
+    static bool load(const std::string &path,
+                     std::vector<Agent> &agents, std::vector<Client> &clients,
+                     std::vector<Property> &properties, std::vector<Contract> &contracts);
+
+    // CRC-32 (IEEE), chainable through 'crc'
+    static uint32_t crc32(const char *data, size_t size, uint32_t crc = 0);
+};
+
+#endif // BINARYSNAPSHOT_H
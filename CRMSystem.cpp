@@ -1,68 +1,256 @@
 #include "CRMSystem.h"
-#include <fstream>
+#include "CSVTokenizer.h"
+#include "CSVRecords.h"
+#include "MappedFile.h"
+#include "BinarySnapshot.h"
+#include "FileUtils.h"
 #include <algorithm>
+#include <array>
 #include <stdexcept>
-#include <sstream>
 #include <iostream>
+#include <future>
+#include <thread>
+#include <optional>
 
-// Helper function to split CSV line
-static std::vector<std::string> splitCSV(const std::string &line) {
-    std::vector<std::string> tokens;
-    std::stringstream ss(line);
-    std::string token;
-    while (std::getline(ss, token, ',')) {
-        tokens.push_back(token);
+// Re-point the index at every element from 'from' onwards (after an erase shifted them)
+template <typename T>
+static void reindexFrom(const std::vector<T> &items, std::unordered_map<int, size_t> &index, size_t from) {
+    for(size_t i = from; i < items.size(); ++i) {
+        index[items[i].getId()] = i;
     }
-    return tokens;
 }
 
-CRMSystem::CRMSystem() : nextAgentId(1), nextClientId(1), nextPropertyId(1), nextContractId(1) {
+// Move the last element into 'slot' and drop the tail; only the moved element's index changes
+template <typename T>
+static void swapAndPop(std::vector<T> &items, std::unordered_map<int, size_t> &index, size_t slot) {
+    if(slot + 1 != items.size()) {
+        items[slot] = std::move(items.back());
+        index[items[slot].getId()] = slot;
+    }
+    items.pop_back();
+}
+
+// Remove every element whose ID is in 'ids'; returns the count removed.
+// SwapAndPop costs O(ids), Stable does a single remove_if pass from the first hit.
+template <typename T>
+static size_t eraseByIds(std::vector<T> &items, std::unordered_map<int, size_t> &index,
+                         const std::unordered_set<int> &ids, RemovalOrder order) {
+    size_t removed = 0;
+    if(order == RemovalOrder::SwapAndPop) {
+        for(int id : ids) {
+            auto it = index.find(id);
+            if(it == index.end())
+                continue;
+            size_t slot = it->second;
+            index.erase(it);
+            swapAndPop(items, index, slot);
+            ++removed;
+        }
+        return removed;
+    }
+
+    size_t first = items.size();
+    for(int id : ids) {
+        auto it = index.find(id);
+        if(it == index.end())
+            continue;
+        first = std::min(first, it->second);
+        index.erase(it);
+    }
+    if(first == items.size())
+        return 0;
+    auto newEnd = std::remove_if(items.begin() + first, items.end(),
+                                 [&ids](const T &item){ return ids.count(item.getId()) != 0; });
+    removed = static_cast<size_t>(items.end() - newEnd);
+    items.erase(newEnd, items.end());
+    reindexFrom(items, index, first);
+    return removed;
+}
+
+// Remove the element with the given ID using its index entry; returns false if absent
+template <typename T>
+static bool eraseById(std::vector<T> &items, std::unordered_map<int, size_t> &index, int id, RemovalOrder order) {
+    auto it = index.find(id);
+    if(it == index.end())
+        return false;
+    size_t slot = it->second;
+    index.erase(it);
+    if(order == RemovalOrder::SwapAndPop) {
+        swapAndPop(items, index, slot);
+    } else {
+        items.erase(items.begin() + slot);
+        reindexFrom(items, index, slot);
+    }
+    return true;
+}
+
+static const char *AGENTS_FILE = "agents_data.csv";
+static const char *CLIENTS_FILE = "clients_data.csv";
+static const char *PROPERTIES_FILE = "properties_data.csv";
+static const char *CONTRACTS_FILE = "contracts_data.csv";
+static const char *SNAPSHOT_FILE = "crm_data.snapshot";
+static const char *DATABASE_FILE = "real_estate.db";
+// Lists the files of a save whose renames are in progress
+static const char *GENERATION_FILE = "crm_data.commit";
+static const char *JOURNAL_FILE = "crm_journal.log";
+// Journal length that triggers a save + truncate
+static const size_t JOURNAL_COMPACT_RECORDS = 10000;
+
+CRMSystem::CRMSystem(StorageFormat format, const DatabaseConfig &databaseConfig)
+    : nextAgentId(1), nextClientId(1), nextPropertyId(1), nextContractId(1),
+      removalPolicy(RemovalPolicy::Restrict), removalOrder(RemovalOrder::SwapAndPop),
+      storageFormat(format), agentsDirty(false), clientsDirty(false),
+      propertiesDirty(false), contractsDirty(false), replaying(false),
+      mutationDepth(0), compactionDue(false),
+      checkpointInterval(0), checkpointStop(false), checkpointRequested(false) {
+    if(storageFormat == StorageFormat::SQLite) {
+        // Every change is written through: no journal to replay or keep
+        database = std::make_unique<SQLiteStorage>(DATABASE_FILE, databaseConfig);
+        loadData();
+        return;
+    }
     loadData();
+    replayJournal();
+    journal = std::make_unique<Journal>(JOURNAL_FILE);
 }
 
 CRMSystem::~CRMSystem() {
-    saveData();
+    stopCheckpointer();
+    try {
+        checkpoint();
+        if(journal)
+            journal->truncate();
+    } catch (const std::exception& e) {
+        // The journal is still on disk and is replayed on the next start
+        std::cerr << "Final checkpoint failed: " << e.what() << std::endl;
+    }
+}
+
+void CRMSystem::setJournalGroupCommit(size_t records) {
+    std::lock_guard<std::recursive_mutex> lock(stateMutex);
+    if(journal)
+        journal->setGroupCommitSize(records);
+}
+
+void CRMSystem::flushJournal() {
+    std::lock_guard<std::recursive_mutex> lock(stateMutex);
+    if(journal)
+        journal->commit();
+}
+
+CRMSystem::MutationLock::MutationLock(CRMSystem &system) : m_system(system) {
+    m_system.stateMutex.lock();
+    ++m_system.mutationDepth;
+}
+
+CRMSystem::MutationLock::~MutationLock() {
+    bool compact = --m_system.mutationDepth == 0 && m_system.compactionDue;
+    if(compact)
+        m_system.compactionDue = false;
+    m_system.stateMutex.unlock();
+    if(compact)
+        m_system.compactJournal();
+}
+
+void CRMSystem::setRemovalPolicy(RemovalPolicy policy) {
+    removalPolicy = policy;
+}
+
+RemovalPolicy CRMSystem::getRemovalPolicy() const {
+    return removalPolicy;
+}
+
+void CRMSystem::setRemovalOrder(RemovalOrder order) {
+    removalOrder = order;
+}
+
+RemovalOrder CRMSystem::getRemovalOrder() const {
+    return removalOrder;
 }
 
 // ------------------------
 // Agent CRUD
 // ------------------------
 void CRMSystem::addAgent(const Agent &agent) {
+    MutationLock lock(*this);
     Agent a = agent;
     if (a.getId() == -1) {
-        a.setId(nextAgentId++);
+        a.setId(nextAgentId);
     }
     if (!a.isValid())
         throw ValidationException("Invalid agent data.");
+    if(agentSlots.count(a.getId()))
+        throw ValidationException("Duplicate agent ID: " + std::to_string(a.getId()));
+    writeThrough(a);
+    agentSlots[a.getId()] = agents.size();
     agents.push_back(a);
+    agentsDirty = true;
+    nextAgentId = std::max(nextAgentId, a.getId() + 1);
+    journalChange(Journal::Add, "agent", a);
 }
 
 bool CRMSystem::removeAgent(int agentId) {
-    auto it = std::remove_if(agents.begin(), agents.end(),
-                             [agentId](const Agent &a){ return a.getId() == agentId; });
-    if(it != agents.end()) {
-        agents.erase(it, agents.end());
-        return true;
+    return removeAgent(agentId, removalPolicy);
+}
+
+bool CRMSystem::removeAgent(int agentId, RemovalPolicy policy) {
+    return removeAgents(std::vector<int>{agentId}, policy) == 1;
+}
+
+size_t CRMSystem::removeAgents(const std::vector<int> &agentIds) {
+    return removeAgents(agentIds, removalPolicy);
+}
+
+size_t CRMSystem::removeAgents(const std::vector<int> &agentIds, RemovalPolicy policy) {
+    MutationLock lock(*this);
+    std::unordered_set<int> ids(agentIds.begin(), agentIds.end());
+    std::unordered_set<int> referencing = referencingContracts(contractsByAgent, ids, policy, "Agent");
+    std::vector<int> existing;
+    for(int id : ids) {
+        if(agentSlots.count(id))
+            existing.push_back(id);
     }
-    return false;
+    if(database) {
+        // The rows and any cascaded contract writes commit together
+        Transaction batch(database->connection());
+        writeThroughRemovalPolicy(referencing, policy, &Contract::setAgentId);
+        writeThroughRemovals("agent", existing);
+        batch.commit();
+    }
+    applyRemovalPolicy(referencing, policy, &Contract::setAgentId);
+    size_t removed = eraseByIds(agents, agentSlots, ids, removalOrder);
+    if(removed > 0)
+        agentsDirty = true;
+    journalRemovals("agent", existing);
+    return removed;
 }
 
 Agent CRMSystem::searchAgentById(int agentId) const {
-    for(const auto &a : agents) {
-        if(a.getId() == agentId)
-            return a;
-    }
-    throw AgentNotFoundException(agentId);
+    const Agent *found = findAgentById(agentId);
+    if(!found)
+        throw AgentNotFoundException(agentId);
+    return *found;
+}
+
+const Agent* CRMSystem::findAgentById(int agentId) const {
+    auto it = agentSlots.find(agentId);
+    return it == agentSlots.end() ? nullptr : &agents[it->second];
+}
+
+bool CRMSystem::agentExists(int agentId) const {
+    return agentSlots.count(agentId) != 0;
 }
 
 bool CRMSystem::modifyAgent(const Agent &modifiedAgent) {
-    for(auto &a : agents) {
-        if(a.getId() == modifiedAgent.getId()) {
-            a = modifiedAgent;
-            return true;
-        }
-    }
-    return false;
+    MutationLock lock(*this);
+    auto it = agentSlots.find(modifiedAgent.getId());
+    if(it == agentSlots.end())
+        return false;
+    writeThrough(modifiedAgent);
+    agents[it->second] = modifiedAgent;
+    agentsDirty = true;
+    journalChange(Journal::Modify, "agent", modifiedAgent);
+    return true;
 }
 
 void CRMSystem::displayAgents() const {
@@ -79,41 +267,85 @@ void CRMSystem::displayAgents() const {
 // Client CRUD
 // ------------------------
 void CRMSystem::addClient(const Client &client) {
+    MutationLock lock(*this);
     Client c = client;
     if(c.getId() == -1) {
-        c.setId(nextClientId++);
+        c.setId(nextClientId);
     }
     if(!c.isValid())
         throw ValidationException("Invalid client data.");
+    if(clientSlots.count(c.getId()))
+        throw ValidationException("Duplicate client ID: " + std::to_string(c.getId()));
+    writeThrough(c);
+    clientSlots[c.getId()] = clients.size();
     clients.push_back(c);
+    clientsDirty = true;
+    nextClientId = std::max(nextClientId, c.getId() + 1);
+    journalChange(Journal::Add, "client", c);
 }
 
 bool CRMSystem::removeClient(int clientId) {
-    auto it = std::remove_if(clients.begin(), clients.end(),
-                             [clientId](const Client &c){ return c.getId() == clientId; });
-    if(it != clients.end()) {
-        clients.erase(it, clients.end());
-        return true;
+    return removeClient(clientId, removalPolicy);
+}
+
+bool CRMSystem::removeClient(int clientId, RemovalPolicy policy) {
+    return removeClients(std::vector<int>{clientId}, policy) == 1;
+}
+
+size_t CRMSystem::removeClients(const std::vector<int> &clientIds) {
+    return removeClients(clientIds, removalPolicy);
+}
+
+size_t CRMSystem::removeClients(const std::vector<int> &clientIds, RemovalPolicy policy) {
+    MutationLock lock(*this);
+    std::unordered_set<int> ids(clientIds.begin(), clientIds.end());
+    std::unordered_set<int> referencing = referencingContracts(contractsByClient, ids, policy, "Client");
+    std::vector<int> existing;
+    for(int id : ids) {
+        if(clientSlots.count(id))
+            existing.push_back(id);
     }
-    return false;
+    if(database) {
+        // The rows and any cascaded contract writes commit together
+        Transaction batch(database->connection());
+        writeThroughRemovalPolicy(referencing, policy, &Contract::setClientId);
+        writeThroughRemovals("client", existing);
+        batch.commit();
+    }
+    applyRemovalPolicy(referencing, policy, &Contract::setClientId);
+    size_t removed = eraseByIds(clients, clientSlots, ids, removalOrder);
+    if(removed > 0)
+        clientsDirty = true;
+    journalRemovals("client", existing);
+    return removed;
 }
 
 Client CRMSystem::searchClientById(int clientId) const {
-    for(const auto &c : clients) {
-        if(c.getId() == clientId)
-            return c;
-    }
-    throw ClientNotFoundException(clientId);
+    const Client *found = findClientById(clientId);
+    if(!found)
+        throw ClientNotFoundException(clientId);
+    return *found;
+}
+
+const Client* CRMSystem::findClientById(int clientId) const {
+    auto it = clientSlots.find(clientId);
+    return it == clientSlots.end() ? nullptr : &clients[it->second];
+}
+
+bool CRMSystem::clientExists(int clientId) const {
+    return clientSlots.count(clientId) != 0;
 }
 
 bool CRMSystem::modifyClient(const Client &modifiedClient) {
-    for(auto &c : clients) {
-        if(c.getId() == modifiedClient.getId()) {
-            c = modifiedClient;
-            return true;
-        }
-    }
-    return false;
+    MutationLock lock(*this);
+    auto it = clientSlots.find(modifiedClient.getId());
+    if(it == clientSlots.end())
+        return false;
+    writeThrough(modifiedClient);
+    clients[it->second] = modifiedClient;
+    clientsDirty = true;
+    journalChange(Journal::Modify, "client", modifiedClient);
+    return true;
 }
 
 void CRMSystem::displayClients() const {
@@ -126,45 +358,143 @@ void CRMSystem::displayClients() const {
     }
 }
 
+std::vector<const Property*> CRMSystem::matchPropertiesForClient(int clientId, size_t limit) const {
+    const Client *client = findClientById(clientId);
+    if(!client)
+        throw ClientNotFoundException(clientId);
+
+    std::vector<const Property*> result;
+    for(const auto &entry : propertyIndex.availableUpTo(listingTypeFor(client->getBudgetType()),
+                                                        client->getBudget(), limit)) {
+        result.push_back(&properties[propertySlots.at(entry.second)]);
+    }
+    return result;
+}
+
+std::unordered_map<int, std::vector<const Property*>> CRMSystem::matchAllClients(size_t limitPerClient) const {
+    // Every client's matches are a prefix of its listing type's price-ordered
+    // available list, at most limitPerClient long, so walk each list once (up
+    // to the largest budget and that length) and binary-search each client's
+    // cut-off in it.
+    std::array<std::optional<double>, LISTING_TYPE_COUNT> maxBudget;
+    for(const auto &c : clients) {
+        auto &budget = maxBudget[static_cast<size_t>(listingTypeFor(c.getBudgetType()))];
+        budget = std::max(budget.value_or(0.0), c.getBudget());
+    }
+
+    std::array<std::vector<std::pair<double, int>>, LISTING_TYPE_COUNT> candidates;
+    for(size_t listing = 0; listing < LISTING_TYPE_COUNT; ++listing) {
+        if(maxBudget[listing])
+            candidates[listing] = propertyIndex.availableUpTo(static_cast<ListingType>(listing), *maxBudget[listing],
+                                                              limitPerClient);
+    }
+
+    std::unordered_map<int, std::vector<const Property*>> matches;
+    matches.reserve(clients.size());
+    for(const auto &c : clients) {
+        const auto &list = candidates[static_cast<size_t>(listingTypeFor(c.getBudgetType()))];
+        auto end = std::upper_bound(list.begin(), list.end(),
+                                    std::make_pair(c.getBudget(), std::numeric_limits<int>::max()));
+        size_t count = std::min(static_cast<size_t>(end - list.begin()), limitPerClient);
+
+        std::vector<const Property*> &out = matches[c.getId()];
+        out.reserve(count);
+        for(size_t i = 0; i < count; ++i) {
+            out.push_back(&properties[propertySlots.at(list[i].second)]);
+        }
+    }
+    return matches;
+}
+
 // ------------------------
 // Property CRUD
 // ------------------------
 void CRMSystem::addProperty(const Property &property) {
+    MutationLock lock(*this);
     Property p = property;
     if(p.getId() == -1) {
-        p.setId(nextPropertyId++);
+        p.setId(nextPropertyId);
     }
     if(!p.isValid())
         throw ValidationException("Invalid property data.");
+    if(propertySlots.count(p.getId()))
+        throw ValidationException("Duplicate property ID: " + std::to_string(p.getId()));
+    writeThrough(p);
+    propertySlots[p.getId()] = properties.size();
     properties.push_back(p);
+    propertiesDirty = true;
+    propertyIndex.insert(p);
+    nextPropertyId = std::max(nextPropertyId, p.getId() + 1);
+    journalChange(Journal::Add, "property", p);
 }
 
 bool CRMSystem::removeProperty(int propertyId) {
-    auto it = std::remove_if(properties.begin(), properties.end(),
-                             [propertyId](const Property &p){ return p.getId() == propertyId; });
-    if(it != properties.end()) {
-        properties.erase(it, properties.end());
-        return true;
+    return removeProperty(propertyId, removalPolicy);
+}
+
+bool CRMSystem::removeProperty(int propertyId, RemovalPolicy policy) {
+    return removeProperties(std::vector<int>{propertyId}, policy) == 1;
+}
+
+size_t CRMSystem::removeProperties(const std::vector<int> &propertyIds) {
+    return removeProperties(propertyIds, removalPolicy);
+}
+
+size_t CRMSystem::removeProperties(const std::vector<int> &propertyIds, RemovalPolicy policy) {
+    MutationLock lock(*this);
+    std::unordered_set<int> ids(propertyIds.begin(), propertyIds.end());
+    std::unordered_set<int> referencing = referencingContracts(contractsByProperty, ids, policy, "Property");
+    std::vector<int> existing;
+    for(int id : ids) {
+        if(propertySlots.count(id))
+            existing.push_back(id);
     }
-    return false;
+    if(database) {
+        // The rows and any cascaded contract writes commit together
+        Transaction batch(database->connection());
+        writeThroughRemovalPolicy(referencing, policy, &Contract::setPropertyId);
+        writeThroughRemovals("property", existing);
+        batch.commit();
+    }
+    applyRemovalPolicy(referencing, policy, &Contract::setPropertyId);
+    for(int id : existing) {
+        propertyIndex.erase(properties[propertySlots.at(id)]);
+    }
+    size_t removed = eraseByIds(properties, propertySlots, ids, removalOrder);
+    if(removed > 0)
+        propertiesDirty = true;
+    journalRemovals("property", existing);
+    return removed;
 }
 
 Property CRMSystem::searchPropertyById(int propertyId) const {
-    for(const auto &p : properties) {
-        if(p.getId() == propertyId)
-            return p;
-    }
-    throw PropertyNotFoundException(propertyId);
+    const Property *found = findPropertyById(propertyId);
+    if(!found)
+        throw PropertyNotFoundException(propertyId);
+    return *found;
+}
+
+const Property* CRMSystem::findPropertyById(int propertyId) const {
+    auto it = propertySlots.find(propertyId);
+    return it == propertySlots.end() ? nullptr : &properties[it->second];
+}
+
+bool CRMSystem::propertyExists(int propertyId) const {
+    return propertySlots.count(propertyId) != 0;
 }
 
 bool CRMSystem::modifyProperty(const Property &modifiedProperty) {
-    for(auto &p : properties) {
-        if(p.getId() == modifiedProperty.getId()) {
-            p = modifiedProperty;
-            return true;
-        }
-    }
-    return false;
+    MutationLock lock(*this);
+    auto it = propertySlots.find(modifiedProperty.getId());
+    if(it == propertySlots.end())
+        return false;
+    writeThrough(modifiedProperty);
+    propertyIndex.erase(properties[it->second]);
+    properties[it->second] = modifiedProperty;
+    propertyIndex.insert(modifiedProperty);
+    propertiesDirty = true;
+    journalChange(Journal::Modify, "property", modifiedProperty);
+    return true;
 }
 
 void CRMSystem::displayProperties() const {
@@ -177,45 +507,99 @@ void CRMSystem::displayProperties() const {
     }
 }
 
+std::vector<const Property*> CRMSystem::resolveProperties(const std::vector<int> &ids) const {
+    std::vector<const Property*> result;
+    result.reserve(ids.size());
+    for(int id : ids) {
+        result.push_back(&properties[propertySlots.at(id)]);
+    }
+    return result;
+}
+
+std::vector<const Property*> CRMSystem::queryProperties(const PropertyQuery &query) const {
+    return resolveProperties(propertyIndex.query(query));
+}
+
+std::vector<const Property*> CRMSystem::queryPropertiesInRange(const PropertyRange &range,
+                                                               const PropertyQuery &filter) const {
+    return resolveProperties(propertyIndex.rangeQuery(range, filter));
+}
+
+std::vector<const Property*> CRMSystem::cheapestProperties(size_t count, const PropertyQuery &filter) const {
+    return resolveProperties(propertyIndex.cheapest(count, filter));
+}
+
+std::vector<const Property*> CRMSystem::largestProperties(size_t count, const PropertyQuery &filter) const {
+    return resolveProperties(propertyIndex.largest(count, filter));
+}
+
 // ------------------------
 // Contract CRUD
 // ------------------------
 void CRMSystem::addContract(const Contract &contract) {
+    MutationLock lock(*this);
     Contract ct = contract;
     if(ct.getId() == -1) {
-        ct.setId(nextContractId++);
+        ct.setId(nextContractId);
     }
     if(!ct.isValid())
         throw ValidationException("Invalid contract data.");
+    if(contractSlots.count(ct.getId()))
+        throw ValidationException("Duplicate contract ID: " + std::to_string(ct.getId()));
+    checkContractReferences(ct);
+    writeThrough(ct);
+    contractSlots[ct.getId()] = contracts.size();
     contracts.push_back(ct);
+    contractsDirty = true;
+    linkContract(ct);
+    nextContractId = std::max(nextContractId, ct.getId() + 1);
+    journalChange(Journal::Add, "contract", ct);
 }
 
 bool CRMSystem::removeContract(int contractId) {
-    auto it = std::remove_if(contracts.begin(), contracts.end(),
-                             [contractId](const Contract &c){ return c.getId() == contractId; });
-    if(it != contracts.end()) {
-        contracts.erase(it, contracts.end());
-        return true;
-    }
-    return false;
+    MutationLock lock(*this);
+    const Contract *existing = findContractById(contractId);
+    if(!existing)
+        return false;
+    writeThroughRemovals("contract", {contractId});
+    unlinkContract(*existing);
+    eraseById(contracts, contractSlots, contractId, removalOrder);
+    contractsDirty = true;
+    journalRemovals("contract", {contractId});
+    return true;
 }
 
 Contract CRMSystem::searchContractById(int contractId) const {
-    for(const auto &c : contracts) {
-        if(c.getId() == contractId)
-            return c;
-    }
-    throw ContractNotFoundException(contractId);
+    const Contract *found = findContractById(contractId);
+    if(!found)
+        throw ContractNotFoundException(contractId);
+    return *found;
+}
+
+const Contract* CRMSystem::findContractById(int contractId) const {
+    auto it = contractSlots.find(contractId);
+    return it == contractSlots.end() ? nullptr : &contracts[it->second];
+}
+
+bool CRMSystem::contractExists(int contractId) const {
+    return contractSlots.count(contractId) != 0;
 }
 
 bool CRMSystem::modifyContract(const Contract &modifiedContract) {
-    for(auto &c : contracts) {
-        if(c.getId() == modifiedContract.getId()) {
-            c = modifiedContract;
-            return true;
-        }
-    }
-    return false;
+    MutationLock lock(*this);
+    auto it = contractSlots.find(modifiedContract.getId());
+    if(it == contractSlots.end())
+        return false;
+    if(!modifiedContract.isValidStored())
+        throw ValidationException("Invalid contract data.");
+    checkContractReferences(modifiedContract);
+    writeThrough(modifiedContract);
+    unlinkContract(contracts[it->second]);
+    contracts[it->second] = modifiedContract;
+    linkContract(modifiedContract);
+    contractsDirty = true;
+    journalChange(Journal::Modify, "contract", modifiedContract);
+    return true;
 }
 
 void CRMSystem::displayContracts() const {
@@ -228,237 +612,734 @@ void CRMSystem::displayContracts() const {
     }
 }
 
+// Posting-list helpers for the contract foreign keys
+// Negative keys are "no reference" and are never posted
+static void addPosting(std::unordered_map<int, std::set<int>> &postings, int key, int contractId) {
+    if(key < 0)
+        return;
+    // New contracts usually carry the largest ID, so hint at the end
+    std::set<int> &ids = postings[key];
+    ids.insert(ids.end(), contractId);
+}
+
+static void removePosting(std::unordered_map<int, std::set<int>> &postings, int key, int contractId) {
+    if(key < 0)
+        return;
+    auto it = postings.find(key);
+    if(it == postings.end())
+        return;
+    it->second.erase(contractId);
+    if(it->second.empty())
+        postings.erase(it);
+}
+
+void CRMSystem::linkContract(const Contract &contract) {
+    addPosting(contractsByAgent, contract.getAgentId(), contract.getId());
+    addPosting(contractsByClient, contract.getClientId(), contract.getId());
+    addPosting(contractsByProperty, contract.getPropertyId(), contract.getId());
+}
+
+void CRMSystem::unlinkContract(const Contract &contract) {
+    removePosting(contractsByAgent, contract.getAgentId(), contract.getId());
+    removePosting(contractsByClient, contract.getClientId(), contract.getId());
+    removePosting(contractsByProperty, contract.getPropertyId(), contract.getId());
+}
+
+void CRMSystem::checkContractReferences(const Contract &contract) const {
+    if(!database)
+        return;
+    auto check = [&](int id, const std::unordered_map<int, size_t> &slots, const char *entity) {
+        if(id >= 0 && !slots.count(id))
+            throw ValidationException("Contract " + std::to_string(contract.getId()) + " references missing " +
+                                      entity + " " + std::to_string(id));
+    };
+    check(contract.getPropertyId(), propertySlots, "property");
+    check(contract.getClientId(), clientSlots, "client");
+    check(contract.getAgentId(), agentSlots, "agent");
+}
+
+std::unordered_set<int> CRMSystem::referencingContracts(const ContractPostings &postings,
+                                                        const std::unordered_set<int> &ids,
+                                                        RemovalPolicy policy, const std::string &entity) const {
+    std::unordered_set<int> referencing;
+    for(int id : ids) {
+        if(id < 0)
+            continue; // "no reference", never a stored entity
+        auto it = postings.find(id);
+        if(it == postings.end())
+            continue;
+        if(policy == RemovalPolicy::Restrict)
+            throw ReferentialIntegrityException(entity, id, it->second.size());
+        referencing.insert(it->second.begin(), it->second.end());
+    }
+    return referencing;
+}
+
+void CRMSystem::writeThroughRemovalPolicy(const std::unordered_set<int> &referencing, RemovalPolicy policy,
+                                          void (Contract::*clearReference)(int)) {
+    if(!database || referencing.empty())
+        return;
+    if(policy == RemovalPolicy::Cascade) {
+        writeThroughRemovals("contract", std::vector<int>(referencing.begin(), referencing.end()));
+        return;
+    }
+    for(int contractId : referencing) {
+        Contract contract = contracts[contractSlots.at(contractId)];
+        (contract.*clearReference)(-1);
+        database->save(contract);
+    }
+}
+
+void CRMSystem::applyRemovalPolicy(const std::unordered_set<int> &referencing, RemovalPolicy policy,
+                                   void (Contract::*clearReference)(int)) {
+    if(referencing.empty())
+        return;
+    contractsDirty = true;
+
+    if(policy == RemovalPolicy::Cascade) {
+        eraseContracts(referencing);
+        return;
+    }
+    for(int contractId : referencing) {
+        Contract &contract = contracts[contractSlots.at(contractId)];
+        unlinkContract(contract);
+        (contract.*clearReference)(-1);
+        linkContract(contract);
+        journalChange(Journal::Modify, "contract", contract);
+    }
+}
+
+void CRMSystem::eraseContracts(const std::unordered_set<int> &contractIds) {
+    std::vector<int> existing;
+    for(int contractId : contractIds) {
+        if(const Contract *contract = findContractById(contractId)) {
+            unlinkContract(*contract);
+            existing.push_back(contractId);
+        }
+    }
+    eraseByIds(contracts, contractSlots, contractIds, removalOrder);
+    journalRemovals("contract", existing);
+}
+
+std::vector<const Contract*> CRMSystem::resolveContracts(const ContractPostings &postings, int id) const {
+    std::vector<const Contract*> result;
+    auto it = postings.find(id);
+    if(it == postings.end())
+        return result;
+    result.reserve(it->second.size());
+    for(int contractId : it->second) {
+        result.push_back(&contracts[contractSlots.at(contractId)]);
+    }
+    return result;
+}
+
+std::vector<const Contract*> CRMSystem::contractsForAgent(int agentId) const {
+    return resolveContracts(contractsByAgent, agentId);
+}
+
+std::vector<const Contract*> CRMSystem::contractsForClient(int clientId) const {
+    return resolveContracts(contractsByClient, clientId);
+}
+
+std::vector<const Contract*> CRMSystem::contractsForProperty(int propertyId) const {
+    return resolveContracts(contractsByProperty, propertyId);
+}
+
+bool CRMSystem::propertyHasActiveContract(int propertyId) const {
+    auto it = contractsByProperty.find(propertyId);
+    if(it == contractsByProperty.end())
+        return false;
+    for(int contractId : it->second) {
+        if(contracts[contractSlots.at(contractId)].getIsActive())
+            return true;
+    }
+    return false;
+}
+
 // Create contract from existing records
 void CRMSystem::createContract(int /*ignored*/, int propertyId, int clientId, int agentId,
                                double price, const std::string &startDateStr,
                                const std::string &endDateStr, const std::string &contractType, bool isActive)
 {
-    // Validate references first
-    try {
-        searchAgentById(agentId);
-    } catch (const AgentNotFoundException& e) {
+    switch(tryCreateContract(propertyId, clientId, agentId, price, startDateStr, endDateStr, contractType, isActive)) {
+    case ContractStatus::Created:
+        return;
+    case ContractStatus::AgentNotFound:
         throw ValidationException("Agent not found: " + std::to_string(agentId));
-    }
-    
-    try {
-        searchClientById(clientId);
-    } catch (const ClientNotFoundException& e) {
+    case ContractStatus::ClientNotFound:
         throw ValidationException("Client not found: " + std::to_string(clientId));
-    }
-    
-    try {
-        searchPropertyById(propertyId);
-    } catch (const PropertyNotFoundException& e) {
+    case ContractStatus::PropertyNotFound:
         throw ValidationException("Property not found: " + std::to_string(propertyId));
+    case ContractStatus::InvalidDate:
+        throw ValidationException("Invalid date format: " + startDateStr + (endDateStr.empty() ? "" : " / " + endDateStr));
+    case ContractStatus::InvalidContractType:
+        throw ValidationException("Contract type must be 'sale' or 'rent'.");
+    case ContractStatus::InvalidData:
+        break;
+    }
+    throw ValidationException("Invalid contract data");
+}
+
+ContractStatus CRMSystem::tryCreateContract(int propertyId, int clientId, int agentId, double price,
+                                            std::string_view startDate, std::string_view endDate,
+                                            std::string_view contractType, bool isActive, int *contractId)
+{
+    MutationLock lock(*this);
+    // Validate references first: index lookups, no entity copies
+    if(!agentExists(agentId))
+        return ContractStatus::AgentNotFound;
+    if(!clientExists(clientId))
+        return ContractStatus::ClientNotFound;
+    if(!propertyExists(propertyId))
+        return ContractStatus::PropertyNotFound;
+
+    // Each date is parsed once, straight into the contract
+    Date start = Date::emptyDate();
+    Date end = Date::emptyDate();
+    if(!CSVTokenizer::tryDate(startDate, start) || start.isEmpty() || !CSVTokenizer::tryDate(endDate, end))
+        return ContractStatus::InvalidDate;
+    ContractType type;
+    if(!fromString(contractType, type))
+        return ContractStatus::InvalidContractType;
+
+    Contract contract;
+    contract.setId(nextContractId);
+    contract.setPropertyId(propertyId);
+    contract.setClientId(clientId);
+    contract.setAgentId(agentId);
+    contract.setPrice(price);
+    contract.setStartDate(start);
+    contract.setEndDate(end);
+    contract.setContractType(type);
+    contract.setIsActive(isActive);
+    if(!contract.isValid())
+        return ContractStatus::InvalidData;
+    addContract(contract);
+    if(contractId)
+        *contractId = contract.getId();
+    return ContractStatus::Created;
+}
+
+// ------------------------
+// Parallel CSV parsing
+// ------------------------
+// Files smaller than this are parsed on the loading thread
+static const size_t MIN_CHUNK_BYTES = 1 << 20;
+
+// Cut 'text' into up to one slice per hardware thread, each ending on a line break
+static std::vector<std::string_view> splitIntoChunks(std::string_view text) {
+    size_t workers = std::max(1u, std::thread::hardware_concurrency());
+    size_t chunkCount = std::min(workers, text.size() / MIN_CHUNK_BYTES + 1);
+    size_t target = text.size() / chunkCount;
+
+    std::vector<std::string_view> chunks;
+    size_t start = 0;
+    while(start < text.size()) {
+        size_t end = text.size();
+        if(chunks.size() + 1 < chunkCount) {
+            size_t newline = text.find('\n', start + target);
+            if(newline != std::string_view::npos)
+                end = newline + 1;
+        }
+        chunks.push_back(text.substr(start, end - start));
+        start = end;
     }
+    return chunks;
+}
 
-    Date startDate;
-    Date endDate = Date::emptyDate();
-    
+// Rows parsed from one slice, plus the largest ID seen in it
+template <typename T>
+struct ParsedChunk {
+    std::vector<T> rows;
+    int maxId = 0;
+};
+
+template <typename T>
+static ParsedChunk<T> parseChunk(std::string_view text, size_t fieldCount,
+                                 T (*parseRow)(const std::string_view*), const char *entity) {
+    ParsedChunk<T> chunk;
+    std::string_view line;
+    std::string_view fields[CSVRecords::MAX_FIELDS];
+    while(CSVTokenizer::nextLine(text, line)) {
+        if(line.empty()) continue;
+        if(CSVTokenizer::split(line, fields, fieldCount) < fieldCount) continue;
+        try {
+            chunk.rows.push_back(parseRow(fields));
+            chunk.maxId = std::max(chunk.maxId, chunk.rows.back().getId());
+        } catch (const std::exception& e) {
+            std::cerr << "Error parsing " << entity << ": " << e.what() << std::endl;
+        }
+    }
+    return chunk;
+}
+
+// Parse a whole data file, large files in parallel line-aligned chunks.
+// Rows come back in file order; maxId is the maximum over all chunks.
+template <typename T>
+static std::vector<T> parseDataFile(const char *path, size_t fieldCount, T (*parseRow)(const std::string_view*),
+                                    const char *entity, int &maxId) {
+    maxId = 0;
+    MappedFile file(path);
+    if(!file.isOpen())
+        return {};
+
+    std::vector<std::string_view> slices = splitIntoChunks(file.contents());
+    std::vector<ParsedChunk<T>> chunks(slices.size());
+    if(slices.size() == 1) {
+        chunks[0] = parseChunk(slices[0], fieldCount, parseRow, entity);
+    } else {
+        std::vector<std::future<ParsedChunk<T>>> pending;
+        for(std::string_view slice : slices) {
+            pending.push_back(std::async(std::launch::async, parseChunk<T>, slice, fieldCount, parseRow, entity));
+        }
+        for(size_t i = 0; i < pending.size(); ++i) {
+            chunks[i] = pending[i].get();
+        }
+    }
+
+    size_t total = 0;
+    for(const auto &chunk : chunks) {
+        total += chunk.rows.size();
+        maxId = std::max(maxId, chunk.maxId);
+    }
+    std::vector<T> rows;
+    rows.reserve(total);
+    for(auto &chunk : chunks) {
+        std::move(chunk.rows.begin(), chunk.rows.end(), std::back_inserter(rows));
+    }
+    return rows;
+}
+
+// ------------------------
+// Write-ahead journal
+// ------------------------
+void CRMSystem::journalRecord(Journal::Operation op, const char *entity, const std::string &payload) {
+    if(replaying || !journal)
+        return;
+    journal->append(op, entity, payload);
+    // Compacted once the outermost MutationLock is released: checkpoint()
+    // takes saveMutex, which must not be acquired under stateMutex
+    if(journal->recordCount() >= JOURNAL_COMPACT_RECORDS)
+        compactionDue = true;
+}
+
+void CRMSystem::compactJournal() {
+    // Every journaled change is already applied in memory: a checkpoint
+    // persists them and rotates the journal
+    if(checkpointThread.joinable()) {
+        requestCheckpoint();
+        return;
+    }
     try {
-        startDate = Date(startDateStr);
-        if (!endDateStr.empty()) {
-            endDate = Date(endDateStr);
+        checkpoint();
+    } catch (const std::exception& e) {
+        // The mutation itself succeeded; its journal record keeps it safe
+        std::cerr << "Journal compaction failed: " << e.what() << std::endl;
+    }
+}
+
+template <typename T>
+void CRMSystem::writeThrough(const T &item) {
+    if(database && !replaying)
+        database->save(item);
+}
+
+void CRMSystem::writeThroughRemovals(const char *entity, const std::vector<int> &ids) {
+    if(!database || replaying)
+        return;
+    for(int id : ids) {
+        database->remove(entity, id);
+    }
+}
+
+template <typename T>
+void CRMSystem::journalChange(Journal::Operation op, const char *entity, const T &item) {
+    if(journal && !replaying)
+        journalRecord(op, entity, CSVRecords::format(item));
+}
+
+void CRMSystem::journalRemovals(const char *entity, const std::vector<int> &ids) {
+    if(!journal || replaying)
+        return;
+    for(int id : ids) {
+        journalRecord(Journal::Remove, entity, std::to_string(id));
+    }
+}
+
+void CRMSystem::replayJournal() {
+    replaying = true;
+    size_t replayed = Journal::replay(JOURNAL_FILE, [this](char op, std::string_view entity, std::string_view payload) {
+        try {
+            applyJournalRecord(op, entity, payload);
+        } catch (const std::exception& e) {
+            std::cerr << "Skipping journal record (" << op << "," << entity << "): " << e.what() << std::endl;
         }
-    } catch (const InvalidDateException& e) {
-        throw ValidationException("Invalid date format: " + std::string(e.what()));
+    });
+    replaying = false;
+    if(replayed > 0)
+        std::cerr << "Recovered " << replayed << " journaled change(s)." << std::endl;
+}
+
+// Replay is idempotent: the data files may already hold some of the journaled
+// changes if the process died after a save, so present adds and missing
+// removes are skipped.
+void CRMSystem::applyJournalRecord(char op, std::string_view entity, std::string_view payload) {
+    std::string_view fields[CSVRecords::MAX_FIELDS];
+    size_t count = CSVTokenizer::split(payload, fields, CSVRecords::MAX_FIELDS);
+    if(op == Journal::Remove) {
+        int id = CSVTokenizer::toInt(fields[0]);
+        if(entity == "agent") removeAgent(id, RemovalPolicy::Restrict);
+        else if(entity == "client") removeClient(id, RemovalPolicy::Restrict);
+        else if(entity == "property") removeProperty(id, RemovalPolicy::Restrict);
+        else if(entity == "contract") removeContract(id);
+        return;
     }
 
-    Contract contract(-1, propertyId, clientId, agentId, price, startDateStr, endDateStr, contractType, isActive);
-    if (!contract.isValid()) {
-        throw ValidationException("Invalid contract data");
+    bool add = op == Journal::Add;
+    if(entity == "agent" && count >= CSVRecords::AGENT_FIELDS) {
+        Agent a = CSVRecords::parseAgent(fields);
+        if(!add) modifyAgent(a);
+        else if(!agentExists(a.getId())) addAgent(a);
+    } else if(entity == "client" && count >= CSVRecords::CLIENT_FIELDS) {
+        Client c = CSVRecords::parseClient(fields);
+        if(!add) modifyClient(c);
+        else if(!clientExists(c.getId())) addClient(c);
+    } else if(entity == "property" && count >= CSVRecords::PROPERTY_FIELDS) {
+        Property p = CSVRecords::parseProperty(fields);
+        if(!add) modifyProperty(p);
+        else if(!propertyExists(p.getId())) addProperty(p);
+    } else if(entity == "contract" && count >= CSVRecords::CONTRACT_FIELDS) {
+        Contract ct = CSVRecords::parseContract(fields);
+        if(!add) modifyContract(ct);
+        else if(!contractExists(ct.getId())) addContract(ct);
     }
-    addContract(contract);
 }
 
 // ------------------------
-// File Persistence
+// Checkpointing
 // ------------------------
-void CRMSystem::loadData() {
-    loadAgents();
-    loadClients();
-    loadProperties();
-    loadContracts();
+// Copies of the collections a checkpoint writes (empty optional = unchanged)
+struct CheckpointCapture {
+    std::optional<std::vector<Agent>> agents;
+    std::optional<std::vector<Client>> clients;
+    std::optional<std::vector<Property>> properties;
+    std::optional<std::vector<Contract>> contracts;
+};
+
+// Rows are formatted into one reused buffer and handed to the file in
+// chunks of about this size
+static const size_t WRITE_CHUNK_BYTES = 1 << 20;
+
+template <typename T>
+static void stageRows(const char *path, const std::vector<T> &items,
+                      std::vector<std::string> &staged, size_t &bytes) {
+    AtomicFileWriter out(path, WRITE_CHUNK_BYTES);
+    std::string buffer;
+    buffer.reserve(WRITE_CHUNK_BYTES + 4096);
+    for(const auto &item : items) {
+        CSVRecords::append(buffer, item);
+        buffer += '\n';
+        if(buffer.size() >= WRITE_CHUNK_BYTES) {
+            out.write(buffer);
+            buffer.clear();
+        }
+    }
+    out.write(buffer);
+    out.sync();
+    staged.push_back(path);
+    bytes += out.bytesWritten();
 }
 
-void CRMSystem::saveData() {
-    saveAgents();
-    saveClients();
-    saveProperties();
-    saveContracts();
+// Returns the number of bytes written
+static size_t writeCheckpoint(StorageFormat format, const CheckpointCapture &capture) {
+    if(format == StorageFormat::Snapshot) {
+        // One file holds everything: the capture has all four collections
+        return BinarySnapshot::save(SNAPSHOT_FILE, *capture.agents, *capture.clients,
+                                    *capture.properties, *capture.contracts);
+    }
+    // Stage every changed collection first; the live files are only
+    // replaced once all of them are safely on disk
+    std::vector<std::string> staged;
+    size_t bytes = 0;
+    if(capture.agents)
+        stageRows(AGENTS_FILE, *capture.agents, staged, bytes);
+    if(capture.clients)
+        stageRows(CLIENTS_FILE, *capture.clients, staged, bytes);
+    if(capture.properties)
+        stageRows(PROPERTIES_FILE, *capture.properties, staged, bytes);
+    if(capture.contracts)
+        stageRows(CONTRACTS_FILE, *capture.contracts, staged, bytes);
+    commitFileGeneration(GENERATION_FILE, staged);
+    return bytes;
 }
 
-void CRMSystem::loadAgents() {
-    std::ifstream in("agents_data.csv");
-    int maxId = 0;
-    if(!in) return;
-    std::string line;
-    while(std::getline(in, line)) {
-        if(line.empty()) continue;
-        auto tokens = splitCSV(line);
-        // Expected 7 tokens: id,firstName,lastName,phone,email,startDate,endDate
-        if(tokens.size() < 7) continue;
-        Agent a;
+static double millisecondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+bool CRMSystem::checkpoint() {
+    std::lock_guard<std::mutex> saving(saveMutex);
+    auto started = std::chrono::steady_clock::now();
+    CheckpointCapture capture;
+    {
+        // The only part that blocks mutations: copy what changed and start
+        // a new journal, so the rotated records are exactly what we persist
+        std::lock_guard<std::recursive_mutex> lock(stateMutex);
+        if(database) {
+            // Already in the database: every change was written through
+            agentsDirty = clientsDirty = propertiesDirty = contractsDirty = false;
+            return false;
+        }
+        if(!agentsDirty && !clientsDirty && !propertiesDirty && !contractsDirty)
+            return false;
+        if(journal)
+            journal->rotate();
+        bool everything = storageFormat == StorageFormat::Snapshot;
+        if(agentsDirty || everything) capture.agents = agents;
+        if(clientsDirty || everything) capture.clients = clients;
+        if(propertiesDirty || everything) capture.properties = properties;
+        if(contractsDirty || everything) capture.contracts = contracts;
+        agentsDirty = clientsDirty = propertiesDirty = contractsDirty = false;
+    }
+    double captureMs = millisecondsSince(started);
+
+    size_t bytes = 0;
+    try {
+        bytes = writeCheckpoint(storageFormat, capture);
+    } catch (...) {
+        {
+            // Still pending: the next checkpoint rewrites them, and the
+            // rotated journal is kept for recovery until then
+            std::lock_guard<std::recursive_mutex> lock(stateMutex);
+            agentsDirty = agentsDirty || capture.agents.has_value();
+            clientsDirty = clientsDirty || capture.clients.has_value();
+            propertiesDirty = propertiesDirty || capture.properties.has_value();
+            contractsDirty = contractsDirty || capture.contracts.has_value();
+        }
+        std::lock_guard<std::mutex> lock(statsMutex);
+        ++checkpointStats.failures;
+        throw;
+    }
+    {
+        std::lock_guard<std::recursive_mutex> lock(stateMutex);
+        if(journal)
+            journal->discardRotated();
+    }
+
+    double durationMs = millisecondsSince(started);
+    std::lock_guard<std::mutex> lock(statsMutex);
+    ++checkpointStats.checkpoints;
+    checkpointStats.lastCaptureMs = captureMs;
+    checkpointStats.lastDurationMs = durationMs;
+    checkpointStats.maxDurationMs = std::max(checkpointStats.maxDurationMs, durationMs);
+    checkpointStats.totalDurationMs += durationMs;
+    checkpointStats.lastBytes = bytes;
+    checkpointStats.totalBytes += bytes;
+    return true;
+}
+
+CheckpointStats CRMSystem::getCheckpointStats() const {
+    std::lock_guard<std::mutex> lock(statsMutex);
+    return checkpointStats;
+}
+
+void CRMSystem::startCheckpointer(std::chrono::milliseconds interval) {
+    stopCheckpointer();
+    checkpointInterval = interval;
+    checkpointStop = false;
+    checkpointRequested = false;
+    checkpointThread = std::thread(&CRMSystem::checkpointLoop, this);
+}
+
+void CRMSystem::stopCheckpointer() {
+    if(!checkpointThread.joinable())
+        return;
+    {
+        std::lock_guard<std::mutex> lock(checkpointMutex);
+        checkpointStop = true;
+    }
+    checkpointWake.notify_one();
+    checkpointThread.join();
+}
+
+void CRMSystem::requestCheckpoint() {
+    {
+        std::lock_guard<std::mutex> lock(checkpointMutex);
+        checkpointRequested = true;
+    }
+    checkpointWake.notify_one();
+}
+
+void CRMSystem::checkpointLoop() {
+    std::unique_lock<std::mutex> lock(checkpointMutex);
+    while(true) {
+        checkpointWake.wait_for(lock, checkpointInterval, [this] { return checkpointStop || checkpointRequested; });
+        if(checkpointStop)
+            return;
+        checkpointRequested = false;
+        lock.unlock();
         try {
-            a.setId(std::stoi(tokens[0]));
-            if(a.getId() > maxId) maxId = a.getId();
-            a.setFirstName(tokens[1]);
-            a.setLastName(tokens[2]);
-            a.setPhone(tokens[3]);
-            a.setEmail(tokens[4]);
-            a.setStartDateFromString(tokens[5]);
-            a.setEndDateFromString(tokens[6]);
-            agents.push_back(a);
+            checkpoint();
         } catch (const std::exception& e) {
-            // Log or handle parsing errors
-            std::cerr << "Error parsing agent: " << e.what() << std::endl;
+            std::cerr << "Background checkpoint failed: " << e.what() << std::endl;
         }
+        lock.lock();
     }
-    in.close();
-    nextAgentId = maxId + 1;
 }
 
-void CRMSystem::saveAgents() {
-    std::ofstream out("agents_data.csv");
-    if(!out) {
-        throw FileOperationException("agents_data.csv", "write");
+// ------------------------
+// File Persistence
+// ------------------------
+void CRMSystem::loadData() {
+    recoverFileGeneration(GENERATION_FILE, {AGENTS_FILE, CLIENTS_FILE, PROPERTIES_FILE, CONTRACTS_FILE, SNAPSHOT_FILE});
+    if(storageFormat == StorageFormat::Snapshot) {
+        loadSnapshot();
+        return;
     }
-    for(const auto &a : agents) {
-        out << a.getId() << ","
-            << a.getFirstName() << ","
-            << a.getLastName() << ","
-            << a.getPhone() << ","
-            << a.getEmail() << ","
-            << a.getStartDateString() << ","
-            << a.getEndDateString() << "\n";
+    if(storageFormat == StorageFormat::SQLite) {
+        database->load(agents, clients, properties, contracts);
+        rebuildIndexes();
+        return;
     }
-    out.close();
+    // Each loader only touches its own collection, ID slots and indexes
+    // (contract postings included), so the four files load concurrently.
+    auto agentsLoaded = std::async(std::launch::async, &CRMSystem::loadAgents, this);
+    auto clientsLoaded = std::async(std::launch::async, &CRMSystem::loadClients, this);
+    auto propertiesLoaded = std::async(std::launch::async, &CRMSystem::loadProperties, this);
+    loadContracts();
+    agentsLoaded.get();
+    clientsLoaded.get();
+    propertiesLoaded.get();
 }
 
-void CRMSystem::loadClients() {
-    std::ifstream in("clients_data.csv");
+bool CRMSystem::hasUnsavedChanges() const {
+    std::lock_guard<std::recursive_mutex> lock(stateMutex);
+    return agentsDirty || clientsDirty || propertiesDirty || contractsDirty;
+}
+
+void CRMSystem::loadSnapshot() {
+    if(BinarySnapshot::load(SNAPSHOT_FILE, agents, clients, properties, contracts))
+        rebuildIndexes();
+}
+
+void CRMSystem::saveSnapshot(const std::string &path) const {
+    BinarySnapshot::save(path, agents, clients, properties, contracts);
+}
+
+// One data file as the loaders see it, duplicate IDs dropped; nothing else is touched
+template <typename T>
+static std::vector<T> readDataFile(const char *path, size_t fieldCount, T (*parseRow)(const std::string_view*),
+                                   const char *entity) {
     int maxId = 0;
-    if(!in) return;
-    std::string line;
-    while(std::getline(in, line)) {
-        if(line.empty()) continue;
-        auto tokens = splitCSV(line);
-        // Expected 8 tokens: id,firstName,lastName,phone,email,isMarried,budget,budgetType
-        if(tokens.size() < 8) continue;
-        Client c;
-        c.setId(std::stoi(tokens[0]));
-        if(c.getId() > maxId) maxId = c.getId();
-        c.setFirstName(tokens[1]);
-        c.setLastName(tokens[2]);
-        c.setPhone(tokens[3]);
-        c.setEmail(tokens[4]);
-        bool married = (std::stoi(tokens[5]) != 0);
-        c.setIsMarried(married);
-        c.setBudget(std::stod(tokens[6]));
-        c.setBudgetType(tokens[7]);
-        clients.push_back(c);
-    }
-    in.close();
-    nextClientId = maxId + 1;
+    std::vector<T> rows = parseDataFile(path, fieldCount, parseRow, entity, maxId);
+    std::unordered_set<int> seen;
+    seen.reserve(rows.size());
+    auto duplicate = [&](const T &item) {
+        if(seen.insert(item.getId()).second)
+            return false;
+        std::cerr << "Skipping duplicate " << entity << " ID: " << item.getId() << std::endl;
+        return true;
+    };
+    rows.erase(std::remove_if(rows.begin(), rows.end(), duplicate), rows.end());
+    return rows;
 }
 
-void CRMSystem::saveClients() {
-    std::ofstream out("clients_data.csv");
-    for(const auto &c : clients) {
-        out << c.getId() << ","
-            << c.getFirstName() << ","
-            << c.getLastName() << ","
-            << c.getPhone() << ","
-            << c.getEmail() << ","
-            << (c.getIsMarried() ? 1 : 0) << ","
-            << c.getBudget() << ","
-            << c.getBudgetType() << "\n";
+void CRMSystem::convertCSVToSnapshot(const std::string &snapshotPath) {
+    // Parsed directly rather than through a CRMSystem, whose journal replay
+    // and final checkpoint would rewrite the CSV files
+    BinarySnapshot::save(snapshotPath,
+                         readDataFile(AGENTS_FILE, CSVRecords::AGENT_FIELDS, CSVRecords::parseAgent, "agent"),
+                         readDataFile(CLIENTS_FILE, CSVRecords::CLIENT_FIELDS, CSVRecords::parseClient, "client"),
+                         readDataFile(PROPERTIES_FILE, CSVRecords::PROPERTY_FIELDS, CSVRecords::parseProperty, "property"),
+                         readDataFile(CONTRACTS_FILE, CSVRecords::CONTRACT_FIELDS, CSVRecords::parseContract, "contract"));
+}
+
+template <typename T>
+static int indexSlots(const std::vector<T> &items, std::unordered_map<int, size_t> &slots) {
+    int maxId = 0;
+    slots.clear();
+    slots.reserve(items.size());
+    for(size_t i = 0; i < items.size(); ++i) {
+        slots[items[i].getId()] = i;
+        maxId = std::max(maxId, items[i].getId());
     }
-    out.close();
+    return maxId;
 }
 
-void CRMSystem::loadProperties() {
-    std::ifstream in("properties_data.csv");
+void CRMSystem::rebuildIndexes() {
+    nextAgentId = indexSlots(agents, agentSlots) + 1;
+    nextClientId = indexSlots(clients, clientSlots) + 1;
+    nextPropertyId = indexSlots(properties, propertySlots) + 1;
+    nextContractId = indexSlots(contracts, contractSlots) + 1;
+
+    propertyIndex.build(properties);
+    contractsByAgent.clear();
+    contractsByClient.clear();
+    contractsByProperty.clear();
+    for(const auto &ct : contracts) {
+        linkContract(ct);
+    }
+}
+
+void CRMSystem::loadAgents() {
     int maxId = 0;
-    if(!in) return;
-    std::string line;
-    while(std::getline(in, line)) {
-        if(line.empty()) continue;
-        auto tokens = splitCSV(line);
-        // Expected 9 tokens: id,sizeSqm,price,propertyType,bedrooms,bathrooms,place,available,listingType
-        if(tokens.size() < 9) continue;
-        Property p;
-        p.setId(std::stoi(tokens[0]));
-        if(p.getId() > maxId) maxId = p.getId();
-        p.setSizeSqm(std::stod(tokens[1]));
-        p.setPrice(std::stod(tokens[2]));
-        p.setPropertyType(tokens[3]);
-        p.setBedrooms(std::stoi(tokens[4]));
-        p.setBathrooms(std::stoi(tokens[5]));
-        p.setPlace(tokens[6]);
-        p.setAvailability(std::stoi(tokens[7]) != 0);
-        p.setListingType(tokens[8]);
-        properties.push_back(p);
-    }
-    in.close();
-    nextPropertyId = maxId + 1;
+    std::vector<Agent> rows = parseDataFile(AGENTS_FILE, CSVRecords::AGENT_FIELDS, CSVRecords::parseAgent, "agent", maxId);
+    agents.reserve(agents.size() + rows.size());
+    for(Agent &a : rows) {
+        if(agentSlots.count(a.getId())) {
+            std::cerr << "Skipping duplicate agent ID: " << a.getId() << std::endl;
+            continue;
+        }
+        agentSlots[a.getId()] = agents.size();
+        agents.push_back(std::move(a));
+    }
+    nextAgentId = maxId + 1;
 }
 
-void CRMSystem::saveProperties() {
-    std::ofstream out("properties_data.csv");
-    for(const auto &p : properties) {
-        out << p.getId() << ","
-            << p.getSizeSqm() << ","
-            << p.getPrice() << ","
-            << p.getPropertyType() << ","
-            << p.getBedrooms() << ","
-            << p.getBathrooms() << ","
-            << p.getPlace() << ","
-            << (p.getAvailability() ? 1 : 0) << ","
-            << p.getListingType() << "\n";
+void CRMSystem::loadClients() {
+    int maxId = 0;
+    std::vector<Client> rows = parseDataFile(CLIENTS_FILE, CSVRecords::CLIENT_FIELDS, CSVRecords::parseClient, "client", maxId);
+    clients.reserve(clients.size() + rows.size());
+    for(Client &c : rows) {
+        if(clientSlots.count(c.getId())) {
+            std::cerr << "Skipping duplicate client ID: " << c.getId() << std::endl;
+            continue;
+        }
+        clientSlots[c.getId()] = clients.size();
+        clients.push_back(std::move(c));
     }
-    out.close();
+    nextClientId = maxId + 1;
 }
 
-void CRMSystem::loadContracts() {
-    std::ifstream in("contracts_data.csv");
+void CRMSystem::loadProperties() {
     int maxId = 0;
-    if(!in) return;
-    std::string line;
-    while(std::getline(in, line)) {
-        if(line.empty()) continue;
-        auto tokens = splitCSV(line);
-        // Expected 9 tokens: id,propertyId,clientId,agentId,price,startDate,endDate,contractType,isActive
-        if(tokens.size() < 9) continue;
-        Contract ct;
-        ct.setId(std::stoi(tokens[0]));
-        if(ct.getId() > maxId) maxId = ct.getId();
-        ct.setPropertyId(std::stoi(tokens[1]));
-        ct.setClientId(std::stoi(tokens[2]));
-        ct.setAgentId(std::stoi(tokens[3]));
-        ct.setPrice(std::stod(tokens[4]));
-        ct.setStartDateFromString(tokens[5]);
-        ct.setEndDateFromString(tokens[6]);
-        ct.setContractType(tokens[7]);
-        ct.setIsActive(std::stoi(tokens[8]) != 0);
-        contracts.push_back(ct);
-    }
-    in.close();
-    nextContractId = maxId + 1;
+    std::vector<Property> rows = parseDataFile(PROPERTIES_FILE, CSVRecords::PROPERTY_FIELDS, CSVRecords::parseProperty, "property", maxId);
+    properties.reserve(properties.size() + rows.size());
+    for(Property &p : rows) {
+        if(propertySlots.count(p.getId())) {
+            std::cerr << "Skipping duplicate property ID: " << p.getId() << std::endl;
+            continue;
+        }
+        propertySlots[p.getId()] = properties.size();
+        properties.push_back(std::move(p));
+    }
+    // One bulk build (sorted, hinted inserts) instead of an insert per row
+    propertyIndex.build(properties);
+    nextPropertyId = maxId + 1;
 }
 
-void CRMSystem::saveContracts() {
-    std::ofstream out("contracts_data.csv");
-    for(const auto &c : contracts) {
-        out << c.getId() << ","
-            << c.getPropertyId() << ","
-            << c.getClientId() << ","
-            << c.getAgentId() << ","
-            << c.getPrice() << ","
-            << c.getStartDateString() << ","  
-            << c.getEndDateString() << "," 
-            << c.getContractType() << ","
-            << (c.getIsActive() ? 1 : 0) << "\n";
-    }
-    out.close();
+void CRMSystem::loadContracts() {
+    int maxId = 0;
+    std::vector<Contract> rows = parseDataFile(CONTRACTS_FILE, CSVRecords::CONTRACT_FIELDS, CSVRecords::parseContract, "contract", maxId);
+    contracts.reserve(contracts.size() + rows.size());
+    for(Contract &ct : rows) {
+        if(contractSlots.count(ct.getId())) {
+            std::cerr << "Skipping duplicate contract ID: " << ct.getId() << std::endl;
+            continue;
+        }
+        contractSlots[ct.getId()] = contracts.size();
+        linkContract(ct);
+        contracts.push_back(std::move(ct));
+    }
+    nextContractId = maxId + 1;
 }
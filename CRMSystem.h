@@ -3,50 +3,201 @@
 
 #include <vector>
 #include <string>
+#include <unordered_map>
+#include <set>
+#include <unordered_set>
+#include <cstddef>
+#include <limits>
+#include <memory>
+#include <string_view>
+#include <chrono>
+#include <mutex>
+#include <thread>
+#include <condition_variable>
 #include "Agent.h"
 #include "Client.h"
 #include "Property.h"
 #include "Contract.h"
 #include "Inspection.h"
+#include "PropertyIndex.h"
+#include "Journal.h"
+#include "AtomicFileWriter.h"
+#include "SQLiteStorage.h"
 #include "Exceptions.h"
 #include "Date.h"
+// What removing an agent/client/property does to the contracts that reference it
+enum class RemovalPolicy {
+    Restrict, // refuse with ReferentialIntegrityException
+    Cascade,  // remove the referencing contracts too
+    SetNull   // keep the contracts, reset the reference to -1
+};
+
+// How a removal closes the gap it leaves in a collection
+enum class RemovalOrder {
+    SwapAndPop, // O(1): the last record moves into the freed slot, iteration order changes
+    Stable      // keep iteration (display/save) order; shifts the tail, O(n)
+};
+
+// Outcome of CRMSystem::tryCreateContract
+enum class ContractStatus {
+    Created,
+    AgentNotFound,
+    ClientNotFound,
+    PropertyNotFound,
+    InvalidDate,         // start date missing or malformed, or end date malformed
+    InvalidContractType, // not "sale" or "rent"
+    InvalidData          // rejected by Contract::isValid (price, date order)
+};
+
+// Where CRMSystem loads from and saves to
+enum class StorageFormat {
+    CSV,     // agents_data.csv, clients_data.csv, properties_data.csv, contracts_data.csv
+    Snapshot, // crm_data.snapshot (see BinarySnapshot)
+    SQLite    // real_estate.db, every change written through (see SQLiteStorage);
+              // still loaded whole and queried in memory like the others
+};
+
+// Counters for checkpoints (background or explicit) that had something to write
+struct CheckpointStats {
+    size_t checkpoints = 0;
+    size_t failures = 0;
+    double lastCaptureMs = 0;   // time mutations were blocked while copying
+    double lastDurationMs = 0;  // capture + write + fsync + rename
+    double maxDurationMs = 0;
+    double totalDurationMs = 0;
+    size_t lastBytes = 0;
+    size_t totalBytes = 0;
+};
+
+// Mutations and queries are made from one thread; the only other thread is
+// the optional checkpointer, which reads the collections under stateMutex.
 class CRMSystem {
 public:
-    CRMSystem();
+    // 'databaseConfig' only applies to StorageFormat::SQLite
+    explicit CRMSystem(StorageFormat format = StorageFormat::CSV,
+                       const DatabaseConfig &databaseConfig = DatabaseConfig::balanced());
     ~CRMSystem();
 
+    // True if any collection changed since it was loaded or last saved
+    bool hasUnsavedChanges() const;
+
+    // Write-ahead journal (crm_journal.log): every mutation is appended and
+    // fsynced in groups of 'records' (default 64); replayed on startup.
+    // A mutation whose record cannot be written throws FileOperationException
+    // after it has been applied in memory (see journalChange)
+    void setJournalGroupCommit(size_t records);
+    // Force buffered journal records to disk now
+    void flushJournal();
+
+    // Background checkpointer: every 'interval' (or sooner once the journal
+    // is due for compaction) it copies the collections changed since the last
+    // checkpoint under the state lock and writes them without holding it.
+    // Calling start again changes the interval.
+    void startCheckpointer(std::chrono::milliseconds interval);
+    void stopCheckpointer();
+    // Persist every change now; false if there was nothing to write.
+    // Throws FileOperationException (the changes stay pending).
+    bool checkpoint();
+    CheckpointStats getCheckpointStats() const;
+
+    // Write the current collections as a binary snapshot
+    void saveSnapshot(const std::string &path) const;
+    // Write the CSV data files out as a snapshot. Only the files are read:
+    // changes still in the journal are not included, and nothing is written
+    // back to the CSV files or the journal.
+    static void convertCSVToSnapshot(const std::string &snapshotPath);
+
+    // Policy used by the single-argument remove*/batch remove* overloads (default Restrict)
+    void setRemovalPolicy(RemovalPolicy policy);
+    RemovalPolicy getRemovalPolicy() const;
+    // Gap-closing strategy for every remove* (default SwapAndPop)
+    void setRemovalOrder(RemovalOrder order);
+    RemovalOrder getRemovalOrder() const;
+
     // AGENT CRUD
     void addAgent(const Agent &agent);
     bool removeAgent(int agentId);
+    bool removeAgent(int agentId, RemovalPolicy policy);
+    // Batch removal: one pass over the agents and one over the contracts; returns the number removed
+    size_t removeAgents(const std::vector<int> &agentIds);
+    size_t removeAgents(const std::vector<int> &agentIds, RemovalPolicy policy);
     Agent searchAgentById(int agentId) const;
+    const Agent* findAgentById(int agentId) const; // nullptr if absent, no copy
+    bool agentExists(int agentId) const;
     bool modifyAgent(const Agent &modifiedAgent);
     void displayAgents() const;
 
     // CLIENT CRUD
     void addClient(const Client &client);
     bool removeClient(int clientId);
+    bool removeClient(int clientId, RemovalPolicy policy);
+    // Batch removal: one pass over the clients and one over the contracts; returns the number removed
+    size_t removeClients(const std::vector<int> &clientIds);
+    size_t removeClients(const std::vector<int> &clientIds, RemovalPolicy policy);
     Client searchClientById(int clientId) const;
+    const Client* findClientById(int clientId) const; // nullptr if absent, no copy
+    bool clientExists(int clientId) const;
     bool modifyClient(const Client &modifiedClient);
     void displayClients() const;
 
+    // Budget matching: available properties whose listing type fits the client's
+    // budget type (rent -> rent, buy -> sale) and whose price is within budget,
+    // cheapest first, at most 'limit' per client
+    std::vector<const Property*> matchPropertiesForClient(int clientId,
+                                                          size_t limit = std::numeric_limits<size_t>::max()) const;
+    // Batch form for every client, keyed by client ID; one index walk per listing type.
+    // Bounded by default: the output grows with clients x limitPerClient
+    std::unordered_map<int, std::vector<const Property*>> matchAllClients(size_t limitPerClient = 10) const;
+
     // PROPERTY CRUD
     void addProperty(const Property &property);
     bool removeProperty(int propertyId);
+    bool removeProperty(int propertyId, RemovalPolicy policy);
+    // Batch removal: one pass over the properties and one over the contracts; returns the number removed
+    size_t removeProperties(const std::vector<int> &propertyIds);
+    size_t removeProperties(const std::vector<int> &propertyIds, RemovalPolicy policy);
     Property searchPropertyById(int propertyId) const;
+    const Property* findPropertyById(int propertyId) const; // nullptr if absent, no copy
+    bool propertyExists(int propertyId) const;
     bool modifyProperty(const Property &modifiedProperty);
     void displayProperties() const;
+    // Filtered search through the secondary indexes; cost follows the smallest matching set
+    std::vector<const Property*> queryProperties(const PropertyQuery &query) const;
+    // Ordered price/size searches (O(log n + k) over the sorted indexes)
+    std::vector<const Property*> queryPropertiesInRange(const PropertyRange &range,
+                                                        const PropertyQuery &filter = {}) const;
+    std::vector<const Property*> cheapestProperties(size_t count, const PropertyQuery &filter = {}) const;
+    std::vector<const Property*> largestProperties(size_t count, const PropertyQuery &filter = {}) const;
 
     // CONTRACT CRUD
     void addContract(const Contract &contract);
     bool removeContract(int contractId);
     Contract searchContractById(int contractId) const;
+    const Contract* findContractById(int contractId) const; // nullptr if absent, no copy
+    bool contractExists(int contractId) const;
+    // False if the ID is unknown; throws ValidationException unless isValidStored()
     bool modifyContract(const Contract &modifiedContract);
     void displayContracts() const;
 
-    // Create a contract from existing records
+    // Contracts referencing a given agent / client / property, ordered by contract ID.
+    // Served from per-entity posting lists, so cost is proportional to that entity's contracts.
+    std::vector<const Contract*> contractsForAgent(int agentId) const;
+    std::vector<const Contract*> contractsForClient(int clientId) const;
+    std::vector<const Contract*> contractsForProperty(int propertyId) const;
+    // Double-booking check: is any active contract attached to the property?
+    bool propertyHasActiveContract(int propertyId) const;
+
+    // Create a contract from existing records; throws ValidationException
+    // naming the first problem found
     void createContract(int contractId, int propertyId, int clientId, int agentId,
                         double price, const std::string &startDate,
                         const std::string &endDate, const std::string &contractType, bool isActive);
+    // Non-throwing form for bulk and import callers: no message is built for
+    // a rejected contract. On success the new ID is stored in 'contractId'
+    // if given. Storage failures (journal, database) still throw.
+    ContractStatus tryCreateContract(int propertyId, int clientId, int agentId, double price,
+                                     std::string_view startDate, std::string_view endDate,
+                                     std::string_view contractType, bool isActive, int *contractId = nullptr);
 
 private:
     std::vector<Agent> agents;
@@ -55,24 +206,120 @@ private:
     std::vector<Contract> contracts;
     std::vector<Inspection> inspections; // Optional
 
+    // ID -> slot in the matching vector above, kept in sync on every add/remove/load
+    std::unordered_map<int, size_t> agentSlots;
+    std::unordered_map<int, size_t> clientSlots;
+    std::unordered_map<int, size_t> propertySlots;
+    std::unordered_map<int, size_t> contractSlots;
+
+    // Secondary indexes on place/type/listing/availability
+    PropertyIndex propertyIndex;
+
     // Auto-generated ID counters
     int nextAgentId;
     int nextClientId;
     int nextPropertyId;
     int nextContractId;
 
+    // Foreign-key adjacency: referenced entity ID -> IDs of contracts pointing at it
+    using ContractPostings = std::unordered_map<int, std::set<int>>;
+    ContractPostings contractsByAgent;
+    ContractPostings contractsByClient;
+    ContractPostings contractsByProperty;
+
+    RemovalPolicy removalPolicy;
+    RemovalOrder removalOrder;
+
+    void linkContract(const Contract &contract);
+    void unlinkContract(const Contract &contract);
+    // SQLite mode: the database rejects a contract whose parties do not
+    // exist, so check before memory changes (throws ValidationException)
+    void checkContractReferences(const Contract &contract) const;
+    // Contracts referencing one of 'ids' through 'postings'; under Restrict
+    // any such contract throws ReferentialIntegrityException instead
+    std::unordered_set<int> referencingContracts(const ContractPostings &postings, const std::unordered_set<int> &ids,
+                                                 RemovalPolicy policy, const std::string &entity) const;
+    // Cascade removes those contracts, SetNull clears the reference with 'clearReference'
+    void writeThroughRemovalPolicy(const std::unordered_set<int> &referencing, RemovalPolicy policy,
+                                   void (Contract::*clearReference)(int));
+    void applyRemovalPolicy(const std::unordered_set<int> &referencing, RemovalPolicy policy,
+                            void (Contract::*clearReference)(int));
+    void eraseContracts(const std::unordered_set<int> &contractIds);
+    std::vector<const Contract*> resolveContracts(const ContractPostings &postings, int id) const;
+    std::vector<const Property*> resolveProperties(const std::vector<int> &ids) const;
+
+    StorageFormat storageFormat;
+
+    // Per-collection dirty flags: set by every mutation, cleared when a
+    // checkpoint captures the collection, so only what changed is rewritten
+    bool agentsDirty;
+    bool clientsDirty;
+    bool propertiesDirty;
+    bool contractsDirty;
+
+    // Journal: records are appended after each mutation is applied, so a
+    // compaction (checkpoint) between two records never loses one
+    std::unique_ptr<Journal> journal;
+    bool replaying;
+    void journalRecord(Journal::Operation op, const char *entity, const std::string &payload);
+    // Checkpoint (or ask the checkpointer for one) once the journal is long
+    // enough; called with no locks held, never throws
+    void compactJournal();
+    // Set in SQLite mode instead of the journal
+    std::unique_ptr<SQLiteStorage> database;
+    // SQLite mode: write a change to the database before memory is touched,
+    // so a failed write (DatabaseException) leaves both as they were
+    template <typename T>
+    void writeThrough(const T &item);
+    void writeThroughRemovals(const char *entity, const std::vector<int> &ids);
+    // Other modes: journal a change once it has been applied. If the journal
+    // write fails (FileOperationException) the change stays applied in memory
+    // and marked dirty, and its record stays buffered: the next journal commit
+    // or checkpoint persists it, but a crash before then loses it
+    template <typename T>
+    void journalChange(Journal::Operation op, const char *entity, const T &item);
+    void journalRemovals(const char *entity, const std::vector<int> &ids);
+    void replayJournal();
+    void applyJournalRecord(char op, std::string_view entity, std::string_view payload);
+
+    // Checkpointing. Lock order: saveMutex, then stateMutex. Mutators hold
+    // stateMutex (recursive, as they call one another) through MutationLock;
+    // saveMutex keeps one checkpoint writing the files at a time.
+    mutable std::recursive_mutex stateMutex;
+    std::mutex saveMutex;
+    // What every mutator holds on stateMutex. Releasing the outermost one
+    // runs a journal compaction that fell due meanwhile, outside the lock.
+    class MutationLock {
+    public:
+        explicit MutationLock(CRMSystem &system);
+        ~MutationLock();
+        MutationLock(const MutationLock&) = delete;
+        MutationLock& operator=(const MutationLock&) = delete;
+    private:
+        CRMSystem &m_system;
+    };
+    int mutationDepth;  // nested MutationLocks held, under stateMutex
+    bool compactionDue; // set by journalRecord, under stateMutex
+    mutable std::mutex statsMutex;
+    CheckpointStats checkpointStats;
+    std::thread checkpointThread;
+    std::mutex checkpointMutex;
+    std::condition_variable checkpointWake;
+    std::chrono::milliseconds checkpointInterval;
+    bool checkpointStop;
+    bool checkpointRequested;
+    void checkpointLoop();
+    void requestCheckpoint();
+
     // File persistence functions
     void loadData();
-    void saveData();
+    void loadSnapshot();
+    // Rebuild ID slots, property/contract indexes and next*Id from the collections
+    void rebuildIndexes();
     void loadAgents();
     void loadClients();
     void loadProperties();
     void loadContracts();
-
-    void saveAgents();
-    void saveClients();
-    void saveProperties();
-    void saveContracts();
 };
 
 #endif // CRMSYSTEM_H
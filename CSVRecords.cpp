@@ -0,0 +1,140 @@
+#include "CSVRecords.h"
+#include "CSVTokenizer.h"
+#include "CSVWriter.h"
+
+// ------------------------
+// Parsers ('f' holds the fields of one line, already split)
+// ------------------------
+Agent CSVRecords::parseAgent(const std::string_view *f) {
+    Agent a;
+    a.setId(CSVTokenizer::toInt(f[0]));
+    a.setFirstName(std::string(f[1]));
+    a.setLastName(std::string(f[2]));
+    a.setPhone(std::string(f[3]));
+    a.setEmail(std::string(f[4]));
+    a.setStartDate(CSVTokenizer::toDate(f[5]));
+    a.setEndDate(CSVTokenizer::toDate(f[6]));
+    return a;
+}
+
+Client CSVRecords::parseClient(const std::string_view *f) {
+    Client c;
+    c.setId(CSVTokenizer::toInt(f[0]));
+    c.setFirstName(std::string(f[1]));
+    c.setLastName(std::string(f[2]));
+    c.setPhone(std::string(f[3]));
+    c.setEmail(std::string(f[4]));
+    c.setIsMarried(CSVTokenizer::toBool(f[5]));
+    c.setBudget(CSVTokenizer::toDouble(f[6]));
+    c.setBudgetType(f[7]);
+    return c;
+}
+
+Property CSVRecords::parseProperty(const std::string_view *f) {
+    Property p;
+    p.setId(CSVTokenizer::toInt(f[0]));
+    p.setSizeSqm(CSVTokenizer::toDouble(f[1]));
+    p.setPrice(CSVTokenizer::toDouble(f[2]));
+    p.setPropertyType(f[3]);
+    p.setBedrooms(CSVTokenizer::toInt(f[4]));
+    p.setBathrooms(CSVTokenizer::toInt(f[5]));
+    p.setPlace(std::string(f[6]));
+    p.setAvailability(CSVTokenizer::toBool(f[7]));
+    p.setListingType(f[8]);
+    return p;
+}
+
+Contract CSVRecords::parseContract(const std::string_view *f) {
+    Contract ct;
+    ct.setId(CSVTokenizer::toInt(f[0]));
+    ct.setPropertyId(CSVTokenizer::toInt(f[1]));
+    ct.setClientId(CSVTokenizer::toInt(f[2]));
+    ct.setAgentId(CSVTokenizer::toInt(f[3]));
+    ct.setPrice(CSVTokenizer::toDouble(f[4]));
+    Date start = CSVTokenizer::toDate(f[5]);
+    Date end = CSVTokenizer::toDate(f[6]);
+    if(!end.isEmpty() && end < start)
+        throw InvalidDateRangeException(start.toString(), end.toString());
+    ct.setStartDate(start);
+    ct.setEndDate(end);
+    ct.setContractType(f[7]);
+    ct.setIsActive(CSVTokenizer::toBool(f[8]));
+    return ct;
+}
+
+// ------------------------
+// Formatters
+// ------------------------
+void CSVRecords::append(std::string &out, const Agent &a) {
+    CSVWriter::appendInt(out, a.getId());
+    out += ',';
+    CSVWriter::appendText(out, a.getFirstName());
+    out += ',';
+    CSVWriter::appendText(out, a.getLastName());
+    out += ',';
+    CSVWriter::appendText(out, a.getPhone());
+    out += ',';
+    CSVWriter::appendText(out, a.getEmail());
+    out += ',';
+    CSVWriter::appendDate(out, a.getStartDate());
+    out += ',';
+    CSVWriter::appendDate(out, a.getEndDate());
+}
+
+void CSVRecords::append(std::string &out, const Client &c) {
+    CSVWriter::appendInt(out, c.getId());
+    out += ',';
+    CSVWriter::appendText(out, c.getFirstName());
+    out += ',';
+    CSVWriter::appendText(out, c.getLastName());
+    out += ',';
+    CSVWriter::appendText(out, c.getPhone());
+    out += ',';
+    CSVWriter::appendText(out, c.getEmail());
+    out += ',';
+    CSVWriter::appendBool(out, c.getIsMarried());
+    out += ',';
+    CSVWriter::appendDouble(out, c.getBudget());
+    out += ',';
+    CSVWriter::appendText(out, toString(c.getBudgetType()));
+}
+
+void CSVRecords::append(std::string &out, const Property &p) {
+    CSVWriter::appendInt(out, p.getId());
+    out += ',';
+    CSVWriter::appendDouble(out, p.getSizeSqm());
+    out += ',';
+    CSVWriter::appendDouble(out, p.getPrice());
+    out += ',';
+    CSVWriter::appendText(out, toString(p.getPropertyType()));
+    out += ',';
+    CSVWriter::appendInt(out, p.getBedrooms());
+    out += ',';
+    CSVWriter::appendInt(out, p.getBathrooms());
+    out += ',';
+    CSVWriter::appendText(out, p.getPlace());
+    out += ',';
+    CSVWriter::appendBool(out, p.getAvailability());
+    out += ',';
+    CSVWriter::appendText(out, toString(p.getListingType()));
+}
+
+void CSVRecords::append(std::string &out, const Contract &ct) {
+    CSVWriter::appendInt(out, ct.getId());
+    out += ',';
+    CSVWriter::appendInt(out, ct.getPropertyId());
+    out += ',';
+    CSVWriter::appendInt(out, ct.getClientId());
+    out += ',';
+    CSVWriter::appendInt(out, ct.getAgentId());
+    out += ',';
+    CSVWriter::appendDouble(out, ct.getPrice());
+    out += ',';
+    CSVWriter::appendDate(out, ct.getStartDate());
+    out += ',';
+    CSVWriter::appendDate(out, ct.getEndDate());
+    out += ',';
+    CSVWriter::appendText(out, toString(ct.getContractType()));
+    out += ',';
+    CSVWriter::appendBool(out, ct.getIsActive());
+}
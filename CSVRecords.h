@@ -0,0 +1,44 @@
+#ifndef CSVRECORDS_H
+#define CSVRECORDS_H
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include "Agent.h"
+#include "Client.h"
+#include "Property.h"
+#include "Contract.h"
+
+// The one-line CSV form of each entity, shared by the data files, the
+// journal payloads and the CSV/SQLite migration tool. format(parse(row))
+// is the canonical text of a row, which is what transfer checksums cover.
+class CSVRecords {
+public:
+    static const size_t AGENT_FIELDS = 7;    // id,firstName,lastName,phone,email,startDate,endDate
+    static const size_t CLIENT_FIELDS = 8;   // id,firstName,lastName,phone,email,isMarried,budget,budgetType
+    static const size_t PROPERTY_FIELDS = 9; // id,sizeSqm,price,propertyType,bedrooms,bathrooms,place,available,listingType
+    static const size_t CONTRACT_FIELDS = 9; // id,propertyId,clientId,agentId,price,startDate,endDate,contractType,isActive
+    static const size_t MAX_FIELDS = 9;
+
+    // 'fields' holds at least the entity's field count, as split by
+    // CSVTokenizer; malformed values throw like the entity setters
+    static Agent parseAgent(const std::string_view *fields);
+    static Client parseClient(const std::string_view *fields);
+    static Property parseProperty(const std::string_view *fields);
+    static Contract parseContract(const std::string_view *fields);
+
+    // Append the row (no line break) to a reused buffer
+    static void append(std::string &out, const Agent &agent);
+    static void append(std::string &out, const Client &client);
+    static void append(std::string &out, const Property &property);
+    static void append(std::string &out, const Contract &contract);
+
+    template <typename T>
+    static std::string format(const T &item) {
+        std::string row;
+        append(row, item);
+        return row;
+    }
+};
+
+#endif // CSVRECORDS_H
@@ -0,0 +1,97 @@
+#include "CSVTokenizer.h"
+#include <charconv>
+#include <string>
+
+bool CSVTokenizer::nextLine(std::string_view &text, std::string_view &line) {
+    if(text.empty())
+        return false;
+    size_t newline = text.find('\n');
+    if(newline == std::string_view::npos) {
+        line = text;
+        text = std::string_view();
+    } else {
+        line = text.substr(0, newline);
+        text.remove_prefix(newline + 1);
+    }
+    return true;
+}
+
+size_t CSVTokenizer::split(std::string_view line, std::string_view *fields, size_t maxFields) {
+    if(!line.empty() && line.back() == '\r')
+        line.remove_suffix(1);
+
+    size_t count = 0;
+    size_t start = 0;
+    while(count < maxFields) {
+        size_t comma = line.find(',', start);
+        if(comma == std::string_view::npos) {
+            fields[count++] = line.substr(start);
+            break;
+        }
+        fields[count++] = line.substr(start, comma - start);
+        start = comma + 1;
+    }
+    return count;
+}
+
+int CSVTokenizer::toInt(std::string_view field) {
+    int value = 0;
+    auto result = std::from_chars(field.data(), field.data() + field.size(), value);
+    if(result.ec != std::errc() || result.ptr != field.data() + field.size())
+        throw ValidationException("Invalid integer field: " + std::string(field));
+    return value;
+}
+
+double CSVTokenizer::toDouble(std::string_view field) {
+    double value = 0.0;
+    auto result = std::from_chars(field.data(), field.data() + field.size(), value);
+    if(result.ec != std::errc() || result.ptr != field.data() + field.size())
+        throw ValidationException("Invalid number field: " + std::string(field));
+    return value;
+}
+
+bool CSVTokenizer::toBool(std::string_view field) {
+    return toInt(field) != 0;
+}
+
+// Parse field[from, from + width) as a non-negative integer
+static bool parseDigits(std::string_view field, size_t from, size_t width, int &out) {
+    if(from + width > field.size())
+        return false;
+    const char *begin = field.data() + from;
+    auto result = std::from_chars(begin, begin + width, out);
+    return result.ec == std::errc() && result.ptr == begin + width;
+}
+
+Date CSVTokenizer::toDate(std::string_view field) {
+    Date date = Date::emptyDate();
+    if(!tryDate(field, date))
+        throw InvalidDateException(std::string(field));
+    return date;
+}
+
+bool CSVTokenizer::tryDate(std::string_view field, Date &date) {
+    if(field.empty()) {
+        date = Date::emptyDate();
+        return true;
+    }
+
+    int year = 0, month = 0, day = 0;
+    bool parsed = false;
+    size_t firstDash = field.find('-');
+    if(firstDash != std::string_view::npos) {
+        size_t secondDash = field.find('-', firstDash + 1);
+        parsed = secondDash != std::string_view::npos
+              && parseDigits(field, 0, firstDash, year)
+              && parseDigits(field, firstDash + 1, secondDash - firstDash - 1, month)
+              && parseDigits(field, secondDash + 1, field.size() - secondDash - 1, day);
+    } else if(field.size() == 8) {
+        parsed = parseDigits(field, 0, 4, year)
+              && parseDigits(field, 4, 2, month)
+              && parseDigits(field, 6, 2, day);
+    }
+    if(!parsed || !Date::isValid(year, month, day))
+        return false;
+    date = Date(year, month, day);
+    return true;
+}
@@ -0,0 +1,34 @@
+#ifndef CSVTOKENIZER_H
+#define CSVTOKENIZER_H
+
+#include <cstddef>
+#include <string_view>
+#include "Date.h"
+#include "Exceptions.h"
+
+// Single-pass, allocation-free CSV field splitting and numeric/date parsing
+// for the data files. Fields are views into the caller's line buffer.
+class CSVTokenizer {
+public:
+    // Pop the next line (without its '\n') off the front of 'text'.
+    // Returns false once 'text' is exhausted.
+    static bool nextLine(std::string_view &text, std::string_view &line);
+
+    // Split 'line' on commas into at most 'maxFields' views; returns the number
+    // of fields found (empty fields, including a trailing one, are kept).
+    // A trailing '\r' (CRLF files) is not part of the last field.
+    static size_t split(std::string_view line, std::string_view *fields, size_t maxFields);
+
+    // Parse a whole field; throw ValidationException on malformed input
+    static int toInt(std::string_view field);
+    static double toDouble(std::string_view field);
+    static bool toBool(std::string_view field); // "0" -> false, other integers -> true
+
+    // "YYYY-MM-DD" or "YYYYMMDD"; an empty field gives Date::emptyDate().
+    // Throws InvalidDateException like Date(const std::string&).
+    static Date toDate(std::string_view field);
+    // Same, but returns false instead of throwing ('date' is left alone)
+    static bool tryDate(std::string_view field, Date &date);
+};
+
+#endif // CSVTOKENIZER_H
@@ -0,0 +1,28 @@
+#include "CSVWriter.h"
+#include <charconv>
+#include <cmath>
+#include <system_error>
+
+void CSVWriter::appendInt(std::string &out, int value) {
+    char buffer[16];
+    auto result = std::to_chars(buffer, buffer + sizeof buffer, value);
+    out.append(buffer, result.ptr);
+}
+
+void CSVWriter::appendDouble(std::string &out, double value) {
+    // Shortest general form is at most 24 characters ("-2.2250738585072014e-308")
+    char buffer[32];
+    std::chars_format format = std::abs(value) < 1e15 ? std::chars_format::fixed : std::chars_format::general;
+    auto result = std::to_chars(buffer, buffer + sizeof buffer, value, format);
+    if(result.ec == std::errc::value_too_large) // tiny values: fixed needs up to ~330 digits
+        result = std::to_chars(buffer, buffer + sizeof buffer, value, std::chars_format::general);
+    out.append(buffer, result.ptr);
+}
+
+void CSVWriter::appendBool(std::string &out, bool value) {
+    out += value ? '1' : '0';
+}
+
+void CSVWriter::appendDate(std::string &out, const Date &date) {
+    date.appendTo(out);
+}
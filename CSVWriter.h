@@ -0,0 +1,24 @@
+#ifndef CSVWRITER_H
+#define CSVWRITER_H
+
+#include <string>
+#include <string_view>
+#include "Date.h"
+
+// Allocation-free field formatting for the data files, the inverse of
+// CSVTokenizer. Everything is appended to a caller-owned buffer that is
+// meant to be reused across rows and flushed in large writes.
+class CSVWriter {
+public:
+    static void appendInt(std::string &out, int value);
+    // Shortest text that parses back to the same double; plain notation for
+    // everyday magnitudes (200000, not 2e+05), scientific where plain would
+    // not fit (1e+15, 1e-300)
+    static void appendDouble(std::string &out, double value);
+    static void appendBool(std::string &out, bool value); // "1" / "0"
+    // "YYYY-MM-DD"; nothing for an empty date
+    static void appendDate(std::string &out, const Date &date);
+    static void appendText(std::string &out, std::string_view text) { out.append(text); }
+};
+
+#endif // CSVWRITER_H
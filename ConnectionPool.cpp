@@ -0,0 +1,132 @@
+#include "ConnectionPool.h"
+#include "Exceptions.h"
+#include <algorithm>
+
+// Each connection is only ever used by the thread holding its lease, so
+// SQLite's per-connection mutex is not needed
+static const int POOL_FLAGS = SQLITE_OPEN_NOMUTEX;
+
+ConnectionPool::ConnectionPool(const std::string &path, size_t readers, const DatabaseConfig &config)
+    : m_writerBusy(false)
+{
+    if(readers == 0)
+        throw ValidationException("A connection pool needs at least one reader.");
+    m_writer = std::make_unique<DatabaseManager>(path, config,
+                                                 SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE | POOL_FLAGS);
+    if(!m_writer->handle())
+        throw DatabaseException("open " + path, "cannot open writer connection");
+    for(size_t i = 0; i < readers; ++i) {
+        auto reader = std::make_unique<DatabaseManager>(path, config, SQLITE_OPEN_READONLY | POOL_FLAGS);
+        if(!reader->handle())
+            throw DatabaseException("open " + path, "cannot open reader connection");
+        m_idleReaders.push_back(reader.get());
+        m_readers.push_back(std::move(reader));
+    }
+    m_stats.readers = readers;
+}
+
+ConnectionPool::~ConnectionPool() = default;
+
+ConnectionPool::Lease ConnectionPool::acquireReader() {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    if(m_idleReaders.empty()) {
+        ++m_stats.readerWaits;
+        auto since = std::chrono::steady_clock::now();
+        m_readerReleased.wait(lock, [this] { return !m_idleReaders.empty(); });
+        recordWait(since);
+    }
+    DatabaseManager *connection = m_idleReaders.back();
+    m_idleReaders.pop_back();
+    ++m_stats.readerCheckouts;
+    m_stats.readersInUse = m_readers.size() - m_idleReaders.size();
+    m_stats.peakReadersInUse = std::max(m_stats.peakReadersInUse, m_stats.readersInUse);
+    return Lease(this, connection, false);
+}
+
+ConnectionPool::Lease ConnectionPool::acquireWriter() {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    if(m_writerBusy) {
+        ++m_stats.writerWaits;
+        auto since = std::chrono::steady_clock::now();
+        m_writerReleased.wait(lock, [this] { return !m_writerBusy; });
+        recordWait(since);
+    }
+    m_writerBusy = true;
+    ++m_stats.writerCheckouts;
+    m_stats.writerInUse = true;
+    return Lease(this, m_writer.get(), true);
+}
+
+// Caller holds m_mutex
+void ConnectionPool::recordWait(std::chrono::steady_clock::time_point since) {
+    double waitedMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - since).count();
+    m_stats.totalWaitMs += waitedMs;
+    m_stats.maxWaitMs = std::max(m_stats.maxWaitMs, waitedMs);
+}
+
+void ConnectionPool::release(DatabaseManager *connection, bool writer) {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if(writer) {
+            m_writerBusy = false;
+            m_stats.writerInUse = false;
+        } else {
+            m_idleReaders.push_back(connection);
+            m_stats.readersInUse = m_readers.size() - m_idleReaders.size();
+        }
+    }
+    if(writer)
+        m_writerReleased.notify_one();
+    else
+        m_readerReleased.notify_one();
+}
+
+ConnectionPool::Stats ConnectionPool::getStats() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    Stats stats = m_stats;
+    // Idle connections only: a leased one's cache belongs to its thread
+    stats.cachedStatements = m_writerBusy ? 0 : m_writer->cachedStatementCount();
+    for(const DatabaseManager *reader : m_idleReaders) {
+        stats.cachedStatements += reader->cachedStatementCount();
+    }
+    return stats;
+}
+
+// ------------------------
+// Lease
+// ------------------------
+ConnectionPool::Lease::Lease(ConnectionPool *pool, DatabaseManager *connection, bool writer)
+    : m_pool(pool), m_connection(connection), m_writer(writer)
+{
+}
+
+ConnectionPool::Lease::Lease(Lease &&other) noexcept
+    : m_pool(other.m_pool), m_connection(other.m_connection), m_writer(other.m_writer)
+{
+    other.m_pool = nullptr;
+    other.m_connection = nullptr;
+}
+
+ConnectionPool::Lease& ConnectionPool::Lease::operator=(Lease &&other) noexcept {
+    if(this != &other) {
+        release();
+        m_pool = other.m_pool;
+        m_connection = other.m_connection;
+        m_writer = other.m_writer;
+        other.m_pool = nullptr;
+        other.m_connection = nullptr;
+    }
+    return *this;
+}
+
+ConnectionPool::Lease::~Lease() {
+    release();
+}
+
+void ConnectionPool::Lease::release() {
+    if(!m_pool)
+        return;
+    m_pool->release(m_connection, m_writer);
+    m_pool = nullptr;
+    m_connection = nullptr;
+}
@@ -0,0 +1,95 @@
+#ifndef CONNECTIONPOOL_H
+#define CONNECTIONPOOL_H
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "DatabaseManager.h"
+
+// Connections to one SQLite database for several threads: a single writer
+// plus a fixed set of read-only connections. In WAL mode readers see the
+// last committed state and never wait for the writer, so reports do not
+// queue behind edits; writes still go one at a time, as SQLite requires.
+//
+// Connections are checked out through Lease objects and returned when the
+// lease is destroyed; a Transaction on a leased connection must end before
+// its lease does. A lease is for one thread at a time. Each connection
+// is a DatabaseManager with its own statement cache, so a hot query is
+// compiled once per connection and then reused. The pool must outlive
+// every lease. Errors throw DatabaseException.
+class ConnectionPool {
+public:
+    // Exclusive use of one pooled connection until destroyed (or moved from)
+    class Lease {
+    public:
+        Lease(Lease &&other) noexcept;
+        Lease& operator=(Lease &&other) noexcept;
+        ~Lease();
+
+        Lease(const Lease&) = delete;
+        Lease& operator=(const Lease&) = delete;
+
+        DatabaseManager& operator*() const { return *m_connection; }
+        DatabaseManager* operator->() const { return m_connection; }
+        bool isWriter() const { return m_writer; }
+
+    private:
+        friend class ConnectionPool;
+        Lease(ConnectionPool *pool, DatabaseManager *connection, bool writer);
+        void release();
+
+        ConnectionPool *m_pool;
+        DatabaseManager *m_connection;
+        bool m_writer;
+    };
+
+    struct Stats {
+        size_t readers = 0;             // read-only connections in the pool
+        size_t readerCheckouts = 0;
+        size_t writerCheckouts = 0;
+        size_t readerWaits = 0;         // checkouts that found no connection free
+        size_t writerWaits = 0;
+        double totalWaitMs = 0.0;       // time spent blocked in acquire*()
+        double maxWaitMs = 0.0;
+        size_t readersInUse = 0;
+        size_t peakReadersInUse = 0;
+        bool writerInUse = false;
+        size_t cachedStatements = 0;    // across all connections
+    };
+
+    // Opens the writer first (creating the file and setting the journal
+    // mode), then 'readers' read-only connections, at least one. The schema
+    // is the caller's business, e.g. migrate() through a writer lease.
+    ConnectionPool(const std::string &path, size_t readers,
+                   const DatabaseConfig &config = DatabaseConfig::balanced());
+    ~ConnectionPool();
+
+    ConnectionPool(const ConnectionPool&) = delete;
+    ConnectionPool& operator=(const ConnectionPool&) = delete;
+
+    // Block until a connection is free
+    Lease acquireReader();
+    Lease acquireWriter();
+
+    Stats getStats() const;
+
+private:
+    void release(DatabaseManager *connection, bool writer);
+    void recordWait(std::chrono::steady_clock::time_point since);
+
+    std::unique_ptr<DatabaseManager> m_writer;
+    std::vector<std::unique_ptr<DatabaseManager>> m_readers;
+    std::vector<DatabaseManager*> m_idleReaders;
+    bool m_writerBusy;
+
+    mutable std::mutex m_mutex;
+    std::condition_variable m_readerReleased;
+    std::condition_variable m_writerReleased;
+    Stats m_stats;
+};
+
+#endif // CONNECTIONPOOL_H
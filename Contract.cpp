@@ -3,7 +3,7 @@
 #include <stdexcept>
 
 Contract::Contract() 
-    : m_id(-1), m_propertyId(-1), m_clientId(-1), m_agentId(-1), m_price(0.0), m_isActive(false), m_contractType("rent")
+    : m_id(-1), m_propertyId(-1), m_clientId(-1), m_agentId(-1), m_price(0.0), m_contractType(ContractType::Rent), m_isActive(false)
 {}
 
 Contract::Contract(int id, int propertyId, int clientId, int agentId,
@@ -22,7 +22,7 @@ int Contract::getAgentId() const { return m_agentId; }
 double Contract::getPrice() const { return m_price; }
 Date Contract::getStartDate() const { return m_startDate; }
 Date Contract::getEndDate() const { return m_endDate; }
-std::string Contract::getContractType() const { return m_contractType; }
+ContractType Contract::getContractType() const { return m_contractType; }
 bool Contract::getIsActive() const { return m_isActive; }
 
 void Contract::setId(int id) { m_id = id; }
@@ -52,7 +52,7 @@ void Contract::setEndDateFromString(const std::string& endDate) {
             m_endDate = Date(endDate);
             
             // Validate that end date is after start date for rental contracts
-            if (m_contractType == "rent" && !m_startDate.isEmpty() && m_endDate < m_startDate) {
+            if (m_contractType == ContractType::Rent && !m_startDate.isEmpty() && m_endDate < m_startDate) {
                 throw InvalidDateRangeException(m_startDate.toString(), m_endDate.toString());
             }
         } catch (const InvalidDateException& e) {
@@ -61,15 +61,23 @@ void Contract::setEndDateFromString(const std::string& endDate) {
     }
 }
 
-void Contract::setContractType(const std::string &contractType) {
-    if(contractType != "sale" && contractType != "rent")
+void Contract::setContractType(ContractType contractType) { m_contractType = contractType; }
+void Contract::setContractType(std::string_view contractType) {
+    if(!fromString(contractType, m_contractType))
         throw ValidationException("Contract type must be 'sale' or 'rent'.");
-    m_contractType = contractType;
 }
 void Contract::setIsActive(bool isActive) { m_isActive = isActive; }
 
 bool Contract::isValid() const {
-    if(m_propertyId < 0 || m_clientId < 0 || m_agentId < 0) 
+    if(m_propertyId < 1 || m_clientId < 1 || m_agentId < 1)
+        return false;
+    return isValidStored();
+}
+
+bool Contract::isValidStored() const {
+    // -1 is "no reference" (RemovalPolicy::SetNull); anything else below 1 is garbage
+    auto reference = [](int id) { return id >= 1 || id == -1; };
+    if(!reference(m_propertyId) || !reference(m_clientId) || !reference(m_agentId))
         return false;
     if(m_price < 0) 
         return false;
@@ -77,8 +85,6 @@ bool Contract::isValid() const {
         return false;
     if(!m_endDate.isEmpty() && m_startDate > m_endDate) 
         return false;
-    if(m_contractType != "sale" && m_contractType != "rent") 
-        return false;
     return true;
 }
 
@@ -90,7 +96,7 @@ std::ostream& operator<<(std::ostream &os, const Contract &contract) {
        << "\nPrice: " << contract.m_price
        << "\nStart: " << contract.m_startDate
        << "\nEnd: " << contract.m_endDate
-       << "\nType: " << contract.m_contractType
+       << "\nType: " << toString(contract.m_contractType)
        << "\nActive: " << (contract.m_isActive ? "Yes" : "No");
     return os;
 }
@@ -98,8 +104,11 @@ std::ostream& operator<<(std::ostream &os, const Contract &contract) {
 std::istream& operator>>(std::istream &is, Contract &contract) {
     // Order: id, propertyId, clientId, agentId, price, startDate, endDate, contractType, isActive (0/1)
     int active;
+    std::string contractType;
     is >> contract.m_id >> contract.m_propertyId >> contract.m_clientId >> contract.m_agentId
-       >> contract.m_price >> contract.m_startDate >> contract.m_endDate >> contract.m_contractType >> active;
+       >> contract.m_price >> contract.m_startDate >> contract.m_endDate >> contractType >> active;
+    if(is && !fromString(contractType, contract.m_contractType))
+        is.setstate(std::ios::failbit);
     contract.m_isActive = (active != 0);
     return is;
 }
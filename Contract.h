@@ -3,8 +3,10 @@
 
 #include <iostream>
 #include <string>
+#include <string_view>
 #include "Exceptions.h"
 #include "Date.h"
+#include "EntityTypes.h"
 
 class Contract {
 public:
@@ -21,7 +23,7 @@ public:
     double getPrice() const;
     Date getStartDate() const;
     Date getEndDate() const;
-    std::string getContractType() const;
+    ContractType getContractType() const;
     bool getIsActive() const;
 
     // Setters
@@ -32,7 +34,8 @@ public:
     void setPrice(double price);
     void setStartDate(const Date &startDate);
     void setEndDate(const Date &endDate);
-    void setContractType(const std::string &contractType); // Must be "sale" or "rent"
+    void setContractType(ContractType contractType);
+    void setContractType(std::string_view contractType); // Must be "sale" or "rent"
     void setIsActive(bool isActive);
 
     // For backward compatibility (used in file operations)
@@ -41,8 +44,11 @@ public:
     void setStartDateFromString(const std::string& startDate);
     void setEndDateFromString(const std::string& endDate);
 
-    // Validation
+    // Validation of a new contract: every reference names a record (>= 1)
     bool isValid() const;
+    // Validation of a stored contract: a reference may also be -1 (none), as
+    // loaded from the data or left by RemovalPolicy::SetNull
+    bool isValidStored() const;
 
     // Overloaded stream operators
     friend std::ostream& operator<<(std::ostream &os, const Contract &contract);
@@ -56,7 +62,7 @@ private:
     double m_price;
     Date m_startDate;
     Date m_endDate;
-    std::string m_contractType; // "sale" or "rent"
+    ContractType m_contractType;
     bool m_isActive;
 };
 
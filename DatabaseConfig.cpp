@@ -0,0 +1,26 @@
+#include "DatabaseConfig.h"
+#include "Exceptions.h"
+
+DatabaseConfig DatabaseConfig::sqliteDefaults() {
+    return DatabaseConfig{"defaults", "DELETE", "FULL", 2000, 0, "DEFAULT", 0, false};
+}
+
+DatabaseConfig DatabaseConfig::durable() {
+    return DatabaseConfig{"durable", "WAL", "FULL", 16 * 1024, 64LL << 20, "MEMORY", 5000, true};
+}
+
+DatabaseConfig DatabaseConfig::balanced() {
+    return DatabaseConfig{"balanced", "WAL", "NORMAL", 64 * 1024, 256LL << 20, "MEMORY", 5000, true};
+}
+
+DatabaseConfig DatabaseConfig::bulkLoad() {
+    return DatabaseConfig{"bulk", "WAL", "OFF", 256 * 1024, 256LL << 20, "MEMORY", 5000, true};
+}
+
+DatabaseConfig DatabaseConfig::fromProfile(const std::string &name) {
+    if(name == "defaults") return sqliteDefaults();
+    if(name == "durable") return durable();
+    if(name == "balanced") return balanced();
+    if(name == "bulk") return bulkLoad();
+    throw ValidationException("Unknown database profile: " + name);
+}
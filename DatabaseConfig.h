@@ -0,0 +1,34 @@
+#ifndef DATABASECONFIG_H
+#define DATABASECONFIG_H
+
+#include <cstdint>
+#include <string>
+
+// Connection settings DatabaseManager applies right after opening, as
+// PRAGMAs plus sqlite3_busy_timeout. Start from a profile and adjust.
+struct DatabaseConfig {
+    std::string profile;         // name the settings came from
+    std::string journalMode;     // DELETE, TRUNCATE, WAL, MEMORY...
+    std::string synchronous;     // OFF, NORMAL, FULL
+    int cacheSizeKiB;            // page cache per connection
+    std::int64_t mmapSizeBytes;  // 0 = read through the VFS only
+    std::string tempStore;       // DEFAULT, FILE, MEMORY
+    int busyTimeoutMs;           // how long to wait on a locked database
+    bool foreignKeys;            // enforce REFERENCES clauses (off in SQLite by default)
+
+    // SQLite's own defaults: rollback journal, FULL sync, ~2 MB cache, no
+    // mmap, foreign keys not enforced
+    static DatabaseConfig sqliteDefaults();
+    // WAL with FULL sync: every commit durable, readers never block the writer
+    static DatabaseConfig durable();
+    // WAL with NORMAL sync (a power loss can drop the last commits, never
+    // corrupts), 64 MB cache, 256 MB mmap, temp tables in memory
+    static DatabaseConfig balanced();
+    // Imports: WAL without fsync and a large cache; only for data that can be reloaded
+    static DatabaseConfig bulkLoad();
+
+    // "defaults", "durable", "balanced" or "bulk"; throws ValidationException otherwise
+    static DatabaseConfig fromProfile(const std::string &name);
+};
+
+#endif // DATABASECONFIG_H
@@ -1,18 +1,48 @@
 #include "DatabaseManager.h"
+#include "Exceptions.h"
+#include "Transaction.h"
+#include <algorithm>
 #include <iostream>
 
-DatabaseManager::DatabaseManager(const std::string& dbName) {
-    if (sqlite3_open(dbName.c_str(), &db)) {
+DatabaseManager::DatabaseManager(const std::string& dbName, const DatabaseConfig& config, int openFlags)
+    : db(nullptr), config(config), statementHits(0), statementMisses(0), transactionDepth(0) {
+    if (sqlite3_open_v2(dbName.c_str(), &db, openFlags, nullptr)) {
         std::cerr << "Can't open database: " << sqlite3_errmsg(db) << std::endl;
+        sqlite3_close(db);
+        db = nullptr;
     } else {
-        std::cout << "Database opened successfully!" << std::endl;
+        // Once per database, not once per pooled reader
+        if (!(openFlags & SQLITE_OPEN_READONLY))
+            std::cout << "Database opened successfully!" << std::endl;
+        configure(config);
     }
 }
 
 DatabaseManager::~DatabaseManager() {
+    // sqlite3_close refuses to close while statements are still alive
+    statements.clear();
     sqlite3_close(db);
 }
 
+void DatabaseManager::configure(const DatabaseConfig& settings) {
+    // PRAGMA arguments cannot be bound; every value here comes from DatabaseConfig.
+    // The journal mode is a property of the file: a read-only connection
+    // cannot change it and uses whatever the writer set.
+    std::string pragmas;
+    if (!isReadOnly())
+        pragmas += "PRAGMA journal_mode = " + settings.journalMode + ";";
+    pragmas +=
+        "PRAGMA synchronous = " + settings.synchronous + ";"
+        "PRAGMA cache_size = " + std::to_string(-settings.cacheSizeKiB) + ";"
+        "PRAGMA mmap_size = " + std::to_string(settings.mmapSizeBytes) + ";"
+        "PRAGMA temp_store = " + settings.tempStore + ";"
+        "PRAGMA foreign_keys = " + (settings.foreignKeys ? "ON" : "OFF") + ";";
+    if (!execute(pragmas))
+        throw DatabaseException("configure (" + settings.profile + ")", sqlite3_errmsg(db));
+    sqlite3_busy_timeout(db, settings.busyTimeoutMs);
+    config = settings;
+}
+
 bool DatabaseManager::execute(const std::string& query) {
     char* errorMessage;
     if (sqlite3_exec(db, query.c_str(), nullptr, nullptr, &errorMessage) != SQLITE_OK) {
@@ -22,3 +52,80 @@ bool DatabaseManager::execute(const std::string& query) {
     }
     return true;
 }
+
+Statement& DatabaseManager::prepare(const std::string& sql) {
+    auto it = statements.find(sql);
+    if (it != statements.end()) {
+        ++statementHits;
+        it->second->reset();
+        return *it->second;
+    }
+    ++statementMisses;
+    auto statement = std::make_unique<Statement>(db, sql);
+    Statement& prepared = *statement;
+    statements.emplace(sql, std::move(statement));
+    return prepared;
+}
+
+void DatabaseManager::clearStatementCache() {
+    statements.clear();
+}
+
+int DatabaseManager::schemaVersion() {
+    Statement& stmt = prepare("PRAGMA user_version;");
+    stmt.step();
+    int version = stmt.getInt(0);
+    stmt.reset();
+    return version;
+}
+
+int DatabaseManager::migrate(const std::vector<Migration>& migrations) {
+    std::vector<Migration> steps(migrations);
+    std::sort(steps.begin(), steps.end(),
+              [](const Migration& a, const Migration& b) { return a.version < b.version; });
+    int current = schemaVersion();
+    int latest = steps.empty() ? 0 : steps.back().version;
+    if (current > latest)
+        throw DatabaseException("migrate", "schema version " + std::to_string(current) +
+                                " is newer than this build supports (" + std::to_string(latest) + ")");
+    if (current == latest)
+        return 0;
+
+    // foreign_keys cannot change inside a transaction, and a table rebuild
+    // (create, copy, drop, rename) would trip it half way through
+    if (!execute("PRAGMA foreign_keys = OFF;"))
+        throw DatabaseException("migrate", sqlite3_errmsg(db));
+    const char* restoreForeignKeys = config.foreignKeys ? "PRAGMA foreign_keys = ON;" : "PRAGMA foreign_keys = OFF;";
+    int applied = 0;
+    try {
+        for (const Migration& step : steps) {
+            if (step.version <= current)
+                continue;
+            std::string operation = "migrate to version " + std::to_string(step.version) +
+                                    " (" + step.description + ")";
+            Transaction tx(*this);
+            if (!execute(step.sql))
+                throw DatabaseException(operation, sqlite3_errmsg(db));
+            Statement& violations = prepare("PRAGMA foreign_key_check;");
+            if (violations.step()) {
+                std::string table = violations.getText(0);
+                violations.reset();
+                throw DatabaseException(operation, "foreign key violation in " + table);
+            }
+            // user_version moves in the same transaction as the step itself
+            if (!execute("PRAGMA user_version = " + std::to_string(step.version) + ";"))
+                throw DatabaseException(operation, sqlite3_errmsg(db));
+            tx.commit();
+            current = step.version;
+            ++applied;
+            std::cout << "Database schema upgraded to version " << step.version
+                      << ": " << step.description << std::endl;
+        }
+    } catch (...) {
+        execute(restoreForeignKeys);
+        throw;
+    }
+    if (!execute(restoreForeignKeys))
+        throw DatabaseException("migrate", sqlite3_errmsg(db));
+    return applied;
+}
@@ -2,17 +2,79 @@
 #define DATABASEMANAGER_H
 
 #include <sqlite3.h>
+#include <memory>
 #include <string>
+#include <unordered_map>
+#include <vector>
+#include "Statement.h"
+#include "DatabaseConfig.h"
+
+// One schema upgrade step: 'sql' (may hold several statements) takes a
+// database from the previous version to 'version'
+struct Migration {
+    int version;
+    const char* description;
+    const char* sql;
+};
 
 class DatabaseManager {
 private:
     sqlite3* db;
+    DatabaseConfig config;
+    // Compiled statements keyed by their SQL text, kept for the connection's lifetime
+    std::unordered_map<std::string, std::unique_ptr<Statement>> statements;
+    size_t statementHits;
+    size_t statementMisses;
+    // Open Transaction objects (the outermost is BEGIN, the rest savepoints)
+    int transactionDepth;
+    friend class Transaction;
 
 public:
-    DatabaseManager(const std::string& dbName);
+    // 'openFlags' as for sqlite3_open_v2, e.g. SQLITE_OPEN_READONLY for a
+    // reader. If the open fails the error is printed and handle() is null.
+    DatabaseManager(const std::string& dbName, const DatabaseConfig& config = DatabaseConfig::balanced(),
+                    int openFlags = SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE);
     ~DatabaseManager();
 
+    DatabaseManager(const DatabaseManager&) = delete;
+    DatabaseManager& operator=(const DatabaseManager&) = delete;
+
+    // Apply journal mode, synchronous, cache, mmap, temp store and busy
+    // timeout (done by the constructor; call again to switch profiles
+    // outside a transaction). Throws DatabaseException.
+    void configure(const DatabaseConfig& config);
+    const DatabaseConfig& getConfig() const { return config; }
+
+    // One-off SQL (may hold several statements); compiled on every call
     bool execute(const std::string& query);
+
+    // The cached statement for 'sql', compiled on first use and reset (rows
+    // rewound, bindings cleared) every time it is returned. Only one user
+    // of a given SQL text at a time: a nested prepare() of the same text
+    // resets the outer one. Throws DatabaseException if 'sql' does not compile.
+    Statement& prepare(const std::string& sql);
+    // Finalize every cached statement (e.g. before schema changes)
+    void clearStatementCache();
+    size_t cachedStatementCount() const { return statements.size(); }
+    size_t statementCacheHits() const { return statementHits; }
+    size_t statementCacheMisses() const { return statementMisses; }
+
+    // PRAGMA user_version: 0 for a new database or one created before migrations
+    int schemaVersion();
+    // Apply, in version order, every migration newer than schemaVersion().
+    // Each step runs in its own transaction together with its user_version
+    // bump, so an interrupted upgrade resumes at the failed step. Foreign
+    // keys are not enforced while steps run (table rebuilds need that), but
+    // each step must leave PRAGMA foreign_key_check clean. Returns the steps
+    // applied; throws DatabaseException, also for a database newer than
+    // the newest migration.
+    int migrate(const std::vector<Migration>& migrations);
+
+    bool inTransaction() const { return transactionDepth > 0; }
+    bool isReadOnly() const { return db && sqlite3_db_readonly(db, "main") == 1; }
+
+    // Raw connection for code that needs the C API directly
+    sqlite3* handle() const { return db; }
 };
 
 #endif
@@ -1,16 +1,21 @@
 #include "Date.h"
-#include <iomanip>
 #include <sstream>
 #include <ctime>
 
 Date::Date() : m_isEmpty(false) {
     // Get current date
+    // Reentrant localtime: entities are default-constructed on loader threads
     std::time_t t = std::time(nullptr);
-    std::tm* now = std::localtime(&t);
+    std::tm now{};
+#ifdef _WIN32
+    localtime_s(&now, &t);
+#else
+    localtime_r(&t, &now);
+#endif
     
-    m_year = now->tm_year + 1900;
-    m_month = now->tm_mon + 1;
-    m_day = now->tm_mday;
+    m_year = now.tm_year + 1900;
+    m_month = now.tm_mon + 1;
+    m_day = now.tm_mday;
 }
 
 Date::Date(int year, int month, int day)
@@ -53,15 +58,23 @@ Date::Date(const std::string& dateStr) : m_isEmpty(false) {
 }
 
 std::string Date::toString() const {
+    std::string text;
+    appendTo(text);
+    return text;
+}
+
+void Date::appendTo(std::string &out) const {
     if (m_isEmpty) {
-        return "";
+        return;
     }
-    
-    std::stringstream ss;
-    ss << std::setw(4) << std::setfill('0') << m_year << "-"
-       << std::setw(2) << std::setfill('0') << m_month << "-"
-       << std::setw(2) << std::setfill('0') << m_day;
-    return ss.str();
+    // Zero-padded YYYY-MM-DD, formatted by hand (this runs for every saved date)
+    char text[10] = {
+        static_cast<char>('0' + m_year / 1000 % 10), static_cast<char>('0' + m_year / 100 % 10),
+        static_cast<char>('0' + m_year / 10 % 10), static_cast<char>('0' + m_year % 10), '-',
+        static_cast<char>('0' + m_month / 10 % 10), static_cast<char>('0' + m_month % 10), '-',
+        static_cast<char>('0' + m_day / 10 % 10), static_cast<char>('0' + m_day % 10)
+    };
+    out.append(text, sizeof text);
 }
 
 bool Date::isValid(int year, int month, int day) {
@@ -19,6 +19,8 @@ public:
     
     // Convert to string in "YYYY-MM-DD" format
     std::string toString() const;
+    // Append the same text to 'out' without a temporary string (nothing if empty)
+    void appendTo(std::string &out) const;
     
     // Check if date is valid
     static bool isValid(int year, int month, int day);
@@ -0,0 +1,48 @@
+#include "EntityTypes.h"
+#include <cctype>
+
+static const std::string_view PROPERTY_TYPE_NAMES[] = {"land", "house", "apartment"};
+static const std::string_view LISTING_TYPE_NAMES[] = {"sale", "rent"};
+static const std::string_view BUDGET_TYPE_NAMES[] = {"rent", "buy"};
+static const std::string_view CONTRACT_TYPE_NAMES[] = {"sale", "rent"};
+
+static bool equalsIgnoreCase(std::string_view text, std::string_view word) {
+    if(text.size() != word.size())
+        return false;
+    for(size_t i = 0; i < text.size(); ++i) {
+        if(std::tolower(static_cast<unsigned char>(text[i])) != word[i])
+            return false;
+    }
+    return true;
+}
+
+template <typename E, size_t N>
+static std::string_view nameOf(E value, const std::string_view (&names)[N]) {
+    size_t index = static_cast<size_t>(value);
+    return index < N ? names[index] : std::string_view();
+}
+
+template <typename E, size_t N>
+static bool lookup(std::string_view text, E &value, const std::string_view (&names)[N]) {
+    for(size_t i = 0; i < N; ++i) {
+        if(equalsIgnoreCase(text, names[i])) {
+            value = static_cast<E>(i);
+            return true;
+        }
+    }
+    return false;
+}
+
+std::string_view toString(PropertyType type) { return nameOf(type, PROPERTY_TYPE_NAMES); }
+std::string_view toString(ListingType type) { return nameOf(type, LISTING_TYPE_NAMES); }
+std::string_view toString(BudgetType type) { return nameOf(type, BUDGET_TYPE_NAMES); }
+std::string_view toString(ContractType type) { return nameOf(type, CONTRACT_TYPE_NAMES); }
+
+bool fromString(std::string_view text, PropertyType &type) { return lookup(text, type, PROPERTY_TYPE_NAMES); }
+bool fromString(std::string_view text, ListingType &type) { return lookup(text, type, LISTING_TYPE_NAMES); }
+bool fromString(std::string_view text, BudgetType &type) { return lookup(text, type, BUDGET_TYPE_NAMES); }
+bool fromString(std::string_view text, ContractType &type) { return lookup(text, type, CONTRACT_TYPE_NAMES); }
+
+ListingType listingTypeFor(BudgetType budget) {
+    return budget == BudgetType::Rent ? ListingType::Rent : ListingType::Sale;
+}
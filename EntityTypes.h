@@ -0,0 +1,35 @@
+#ifndef ENTITYTYPES_H
+#define ENTITYTYPES_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+// The fixed vocabularies of the entity records, one byte each. The words
+// only exist at the edges (data files, journal, database, console input and
+// display): fromString() accepts them in any case and returns false for
+// anything else, toString() gives the lowercase form that is written out.
+enum class PropertyType : std::uint8_t { Land, House, Apartment };
+enum class ListingType : std::uint8_t { Sale, Rent };
+enum class BudgetType : std::uint8_t { Rent, Buy };
+enum class ContractType : std::uint8_t { Sale, Rent };
+
+const size_t PROPERTY_TYPE_COUNT = 3;
+const size_t LISTING_TYPE_COUNT = 2;
+
+// Empty for a value outside the enumeration
+std::string_view toString(PropertyType type);
+std::string_view toString(ListingType type);
+std::string_view toString(BudgetType type);
+std::string_view toString(ContractType type);
+
+bool fromString(std::string_view text, PropertyType &type);
+bool fromString(std::string_view text, ListingType &type);
+bool fromString(std::string_view text, BudgetType &type);
+bool fromString(std::string_view text, ContractType &type);
+
+// Listings a client's budget is matched against: rentals for a rent
+// budget, sales for a buy budget
+ListingType listingTypeFor(BudgetType budget);
+
+#endif // ENTITYTYPES_H
@@ -97,6 +97,24 @@ private:
     std::string endDate;
 };
 
+// Raised when a removal would leave contracts pointing at a missing record
+class ReferentialIntegrityException : public CRMException {
+public:
+    ReferentialIntegrityException(const std::string& entity, int id, size_t referencingContracts)
+        : CRMException(entity + " with ID " + std::to_string(id) + " is still referenced by "
+                       + std::to_string(referencingContracts) + " contract(s)"),
+          entityType(entity), entityId(id), contractCount(referencingContracts) {}
+
+    std::string getEntityType() const { return entityType; }
+    int getEntityId() const { return entityId; }
+    size_t getContractCount() const { return contractCount; }
+
+private:
+    std::string entityType;
+    int entityId;
+    size_t contractCount;
+};
+
 class FileOperationException : public CRMException {
 public:
     FileOperationException(const std::string& filename, const std::string& operation) 
@@ -111,6 +129,19 @@ private:
     std::string operation;
 };
 
+// Raised when SQLite rejects a statement (message is sqlite3_errmsg)
+class DatabaseException : public CRMException {
+public:
+    DatabaseException(const std::string& operation, const std::string& message)
+        : CRMException("Database error during " + operation + ": " + message),
+          operation(operation) {}
+
+    std::string getOperation() const { return operation; }
+
+private:
+    std::string operation;
+};
+
 class AuthenticationException : public CRMException {
 public:
     AuthenticationException(const std::string& username) 
@@ -0,0 +1,102 @@
+#include "FileUtils.h"
+#include "AtomicFileWriter.h"
+#include "CSVTokenizer.h"
+#include "Exceptions.h"
+#include "MappedFile.h"
+#include <iostream>
+
+#ifdef _WIN32
+#include <io.h>
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+bool flushAndSync(std::FILE *file) {
+    if(!file || std::fflush(file) != 0)
+        return false;
+#ifdef _WIN32
+    return _commit(_fileno(file)) == 0;
+#else
+    return fsync(fileno(file)) == 0;
+#endif
+}
+
+bool replaceFile(const std::string &from, const std::string &to) {
+#ifdef _WIN32
+    return MoveFileExA(from.c_str(), to.c_str(), MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) != 0;
+#else
+    return std::rename(from.c_str(), to.c_str()) == 0;
+#endif
+}
+
+void syncParentDirectory(const std::string &path) {
+#ifndef _WIN32
+    size_t slash = path.find_last_of('/');
+    std::string dir = slash == std::string::npos ? "." : (slash == 0 ? "/" : path.substr(0, slash));
+    int fd = open(dir.c_str(), O_RDONLY);
+    if(fd >= 0) {
+        fsync(fd);
+        close(fd);
+    }
+#else
+    (void)path;
+#endif
+}
+
+static bool fileExists(const std::string &path) {
+    std::FILE *file = std::fopen(path.c_str(), "rb");
+    if(!file)
+        return false;
+    std::fclose(file);
+    return true;
+}
+
+void commitFileGeneration(const std::string &markerPath, const std::vector<std::string> &paths) {
+    if(paths.empty())
+        return;
+    AtomicFileWriter marker(markerPath, 4096);
+    for(const auto &path : paths) {
+        marker.write(path);
+        marker.write('\n');
+    }
+    marker.commit(); // the generation is durable from here on
+
+    for(const auto &path : paths) {
+        if(!replaceFile(AtomicFileWriter::tempPathFor(path), path))
+            throw FileOperationException(path, "replace");
+    }
+    syncParentDirectory(markerPath);
+    std::remove(markerPath.c_str());
+}
+
+void recoverFileGeneration(const std::string &markerPath, const std::vector<std::string> &paths) {
+    std::vector<std::string> committed;
+    {
+        MappedFile marker(markerPath);
+        if(marker.isOpen()) {
+            std::string_view text = marker.contents(), line;
+            while(CSVTokenizer::nextLine(text, line)) {
+                if(!line.empty())
+                    committed.emplace_back(line);
+            }
+        }
+    }
+    if(!committed.empty()) {
+        // Marker written: every temp file listed is complete, finish the renames
+        for(const auto &path : committed) {
+            std::string temp = AtomicFileWriter::tempPathFor(path);
+            if(fileExists(temp) && !replaceFile(temp, path))
+                throw FileOperationException(path, "recover");
+        }
+        syncParentDirectory(markerPath);
+        std::cerr << "Completed an interrupted save of " << committed.size() << " file(s)." << std::endl;
+    }
+    std::remove(markerPath.c_str());
+    std::remove(AtomicFileWriter::tempPathFor(markerPath).c_str());
+    // Anything still staged belongs to a save that never committed
+    for(const auto &path : paths) {
+        std::remove(AtomicFileWriter::tempPathFor(path).c_str());
+    }
+}
@@ -0,0 +1,29 @@
+#ifndef FILEUTILS_H
+#define FILEUTILS_H
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+// Flush stdio buffers and force the file's data to stable storage
+// (fsync on POSIX, _commit on Windows). Returns false on failure.
+bool flushAndSync(std::FILE *file);
+
+// Atomically rename 'from' over 'to' (rename on POSIX, MoveFileEx with
+// write-through on Windows). Returns false on failure.
+bool replaceFile(const std::string &from, const std::string &to);
+
+// Make renames in the directory containing 'path' durable (no-op on Windows)
+void syncParentDirectory(const std::string &path);
+
+// Publish several files staged by AtomicFileWriter (already synced) as one
+// generation: a marker listing them is written first, so after a crash
+// recoverFileGeneration() either finishes every rename or none happened.
+// Throws FileOperationException.
+void commitFileGeneration(const std::string &markerPath, const std::vector<std::string> &paths);
+
+// Run before loading: roll an interrupted generation forward if its marker
+// exists, otherwise delete leftover temp files of an unfinished save.
+void recoverFileGeneration(const std::string &markerPath, const std::vector<std::string> &paths);
+
+#endif // FILEUTILS_H
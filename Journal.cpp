@@ -0,0 +1,126 @@
+#include "Journal.h"
+#include "CSVTokenizer.h"
+#include "Exceptions.h"
+#include "FileUtils.h"
+#include "MappedFile.h"
+
+Journal::Journal(const std::string &path, size_t groupCommitSize)
+    : m_path(path), m_file(std::fopen(path.c_str(), "ab")), m_buffered(0),
+      m_groupCommitSize(groupCommitSize == 0 ? 1 : groupCommitSize), m_recordCount(0)
+{
+    if(!m_file)
+        throw FileOperationException(path, "open journal");
+}
+
+Journal::~Journal() {
+    try {
+        commit();
+    } catch (const std::exception&) {
+        // Nothing sensible to do while unwinding; the records are lost
+    }
+    if(m_file)
+        std::fclose(m_file);
+}
+
+void Journal::append(Operation op, const char *entity, const std::string &payload) {
+    m_buffer += static_cast<char>(op);
+    m_buffer += ',';
+    m_buffer += entity;
+    m_buffer += ',';
+    m_buffer += payload;
+    m_buffer += '\n';
+    ++m_recordCount;
+    if(++m_buffered >= m_groupCommitSize)
+        commit();
+}
+
+void Journal::commit() {
+    if(m_buffered == 0)
+        return;
+    // A failed truncate leaves the journal closed; open it again
+    if(!m_file && !(m_file = std::fopen(m_path.c_str(), "ab")))
+        throw FileOperationException(m_path, "reopen journal");
+    if(std::fwrite(m_buffer.data(), 1, m_buffer.size(), m_file) != m_buffer.size() || !flushAndSync(m_file))
+        throw FileOperationException(m_path, "append journal");
+    m_buffer.clear();
+    m_buffered = 0;
+}
+
+void Journal::setGroupCommitSize(size_t records) {
+    m_groupCommitSize = records == 0 ? 1 : records;
+    if(m_buffered >= m_groupCommitSize)
+        commit();
+}
+
+std::string Journal::rotatedPath(const std::string &path) {
+    return path + ".1";
+}
+
+void Journal::rotate() {
+    commit();
+    std::string rotated = rotatedPath(m_path);
+    std::FILE *previous = std::fopen(rotated.c_str(), "ab");
+    if(!previous)
+        throw FileOperationException(rotated, "rotate journal");
+    // Usually empty: the rotated file is discarded after every successful checkpoint
+    bool appended = true;
+    {
+        MappedFile current(m_path);
+        std::string_view text = current.contents();
+        appended = std::fwrite(text.data(), 1, text.size(), previous) == text.size();
+    }
+    appended = flushAndSync(previous) && appended;
+    std::fclose(previous);
+    if(!appended)
+        throw FileOperationException(rotated, "rotate journal");
+    truncateCurrent();
+}
+
+void Journal::discardRotated() {
+    std::remove(rotatedPath(m_path).c_str());
+}
+
+void Journal::truncate() {
+    m_buffer.clear();
+    m_buffered = 0;
+    truncateCurrent();
+    discardRotated();
+}
+
+void Journal::truncateCurrent() {
+    m_recordCount = 0;
+    // freopen closes the old stream even when it fails
+    m_file = m_file ? std::freopen(m_path.c_str(), "wb", m_file) : std::fopen(m_path.c_str(), "wb");
+    if(!m_file || !flushAndSync(m_file))
+        throw FileOperationException(m_path, "truncate journal");
+}
+
+static size_t replayFile(const std::string &path, const Journal::ReplayFn &apply) {
+    MappedFile file(path);
+    if(!file.isOpen())
+        return 0;
+
+    std::string_view text = file.contents();
+    // A crash mid-append can leave a partial last record; only replay complete lines
+    size_t end = text.rfind('\n');
+    text = end == std::string_view::npos ? std::string_view() : text.substr(0, end + 1);
+
+    size_t replayed = 0;
+    std::string_view line;
+    while(CSVTokenizer::nextLine(text, line)) {
+        if(line.size() < 4 || line[1] != ',')
+            continue;
+        size_t entityEnd = line.find(',', 2);
+        if(entityEnd == std::string_view::npos)
+            continue;
+        apply(line[0], line.substr(2, entityEnd - 2), line.substr(entityEnd + 1));
+        ++replayed;
+    }
+    return replayed;
+}
+
+size_t Journal::replay(const std::string &path, const ReplayFn &apply) {
+    // Records of an unfinished checkpoint come first
+    size_t replayed = replayFile(rotatedPath(path), apply);
+    return replayed + replayFile(path, apply);
+}
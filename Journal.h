@@ -0,0 +1,67 @@
+#ifndef JOURNAL_H
+#define JOURNAL_H
+
+#include <cstddef>
+#include <cstdio>
+#include <functional>
+#include <string>
+#include <string_view>
+
+// Append-only write-ahead log of CRUD operations made since the last save.
+//
+// One record per line: <op>,<entity>,<payload>
+//   op      'A' add, 'M' modify, 'R' remove
+//   entity  "agent", "client", "property" or "contract"
+//   payload the entity's CSV row (add/modify) or its ID (remove)
+// Records are buffered and written + fsynced as a group every
+// 'groupCommitSize' records, or on commit(). A torn final line (no '\n')
+// is ignored on replay.
+//
+// A checkpoint rotate()s the journal: records written so far move to
+// "<path>.1" and stay there until the checkpoint that covers them has been
+// written (discardRotated); replay reads "<path>.1" before "<path>".
+class Journal {
+public:
+    enum Operation : char { Add = 'A', Modify = 'M', Remove = 'R' };
+
+    using ReplayFn = std::function<void(char op, std::string_view entity, std::string_view payload)>;
+
+    explicit Journal(const std::string &path, size_t groupCommitSize = 64);
+    ~Journal(); // commits any buffered records
+
+    Journal(const Journal&) = delete;
+    Journal& operator=(const Journal&) = delete;
+
+    void append(Operation op, const char *entity, const std::string &payload);
+    // Write and fsync the buffered records; throws FileOperationException on
+    // failure and keeps them buffered for the next attempt
+    void commit();
+    // Drop everything: called once the records are part of a successful save
+    void truncate();
+    // Commit and move the current records to "<path>.1" (appending if an
+    // earlier checkpoint failed to discard it); the journal starts empty
+    void rotate();
+    // Drop the rotated records once a checkpoint has persisted them
+    void discardRotated();
+
+    void setGroupCommitSize(size_t records);
+    // Records appended since the last truncate/rotate (committed or still buffered)
+    size_t recordCount() const { return m_recordCount; }
+
+    // Feed every complete record in the journal at 'path' to 'apply', in order.
+    // Returns the number of records replayed (0 if there is no journal).
+    static size_t replay(const std::string &path, const ReplayFn &apply);
+    static std::string rotatedPath(const std::string &path);
+
+private:
+    void truncateCurrent();
+
+    std::string m_path;
+    std::FILE *m_file; // nullptr after a failed truncate, until commit() reopens it
+    std::string m_buffer;
+    size_t m_buffered;
+    size_t m_groupCommitSize;
+    size_t m_recordCount;
+};
+
+#endif // JOURNAL_H
@@ -0,0 +1,100 @@
+#include "MappedFile.h"
+#include <fstream>
+#include <iterator>
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+MappedFile::MappedFile(const std::string &path)
+    : m_data(nullptr), m_size(0), m_open(false), m_mapped(false)
+#ifdef _WIN32
+    , m_fileHandle(nullptr), m_mappingHandle(nullptr)
+#endif
+{
+    m_open = map(path) || readFallback(path);
+}
+
+MappedFile::~MappedFile() {
+    if(!m_mapped)
+        return;
+#ifdef _WIN32
+    UnmapViewOfFile(m_data);
+    CloseHandle(m_mappingHandle);
+    CloseHandle(m_fileHandle);
+#else
+    munmap(const_cast<char*>(m_data), m_size);
+#endif
+}
+
+#ifdef _WIN32
+bool MappedFile::map(const std::string &path) {
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                              OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if(file == INVALID_HANDLE_VALUE)
+        return false;
+    LARGE_INTEGER size;
+    if(!GetFileSizeEx(file, &size) || size.QuadPart == 0) {
+        CloseHandle(file);
+        return false;
+    }
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if(!mapping) {
+        CloseHandle(file);
+        return false;
+    }
+    void *view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if(!view) {
+        CloseHandle(mapping);
+        CloseHandle(file);
+        return false;
+    }
+    m_fileHandle = file;
+    m_mappingHandle = mapping;
+    m_data = static_cast<const char*>(view);
+    m_size = static_cast<size_t>(size.QuadPart);
+    m_mapped = true;
+    return true;
+}
+#else
+bool MappedFile::map(const std::string &path) {
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if(fd < 0)
+        return false;
+    struct stat info;
+    if(fstat(fd, &info) != 0 || info.st_size == 0) {
+        ::close(fd);
+        return false;
+    }
+    void *view = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd); // the mapping keeps the file referenced
+    if(view == MAP_FAILED)
+        return false;
+    madvise(view, static_cast<size_t>(info.st_size), MADV_SEQUENTIAL);
+    m_data = static_cast<const char*>(view);
+    m_size = static_cast<size_t>(info.st_size);
+    m_mapped = true;
+    return true;
+}
+#endif
+
+bool MappedFile::readFallback(const std::string &path) {
+    std::ifstream in(path, std::ios::binary);
+    if(!in)
+        return false;
+    m_buffer.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    m_data = m_buffer.data();
+    m_size = m_buffer.size();
+    return true;
+}
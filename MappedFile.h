@@ -0,0 +1,38 @@
+#ifndef MAPPEDFILE_H
+#define MAPPEDFILE_H
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+// Read-only view of a whole file. The file is memory-mapped when the platform
+// allows it; otherwise (or for empty files) it is read into an owned buffer
+// through std::ifstream, so callers always get one contiguous view.
+class MappedFile {
+public:
+    explicit MappedFile(const std::string &path);
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    bool isOpen() const { return m_open; }
+    bool isMapped() const { return m_mapped; }
+    std::string_view contents() const { return std::string_view(m_data, m_size); }
+
+private:
+    const char *m_data;
+    size_t m_size;
+    bool m_open;
+    bool m_mapped;
+    std::string m_buffer; // fallback storage when mapping is not possible
+#ifdef _WIN32
+    void *m_fileHandle;
+    void *m_mappingHandle;
+#endif
+
+    bool map(const std::string &path);
+    bool readFallback(const std::string &path);
+};
+
+#endif // MAPPEDFILE_H
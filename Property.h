@@ -3,7 +3,9 @@
 
 #include <iostream>
 #include <string>
+#include <string_view>
 #include "Exceptions.h"
+#include "EntityTypes.h"
 
 class Property {
 public:
@@ -16,23 +18,25 @@ public:
     int getId() const;
     double getSizeSqm() const;
     double getPrice() const;
-    std::string getPropertyType() const;
+    PropertyType getPropertyType() const;
     int getBedrooms() const;
     int getBathrooms() const;
-    std::string getPlace() const;
+    const std::string& getPlace() const;
     bool getAvailability() const;
-    std::string getListingType() const;
+    ListingType getListingType() const;
 
     // Setters
     void setId(int id);
     void setSizeSqm(double sizeSqm);
     void setPrice(double price);
-    void setPropertyType(const std::string &propertyType); // "land", "house", or "apartment"
+    void setPropertyType(PropertyType propertyType);
+    void setPropertyType(std::string_view propertyType); // "land", "house", or "apartment"
     void setBedrooms(int bedrooms);
     void setBathrooms(int bathrooms);
     void setPlace(const std::string &place);
     void setAvailability(bool available);
-    void setListingType(const std::string &listingType); // "sale" or "rent"
+    void setListingType(ListingType listingType);
+    void setListingType(std::string_view listingType); // "sale" or "rent"
 
     // Validation
     bool isValid() const;
@@ -45,12 +49,12 @@ private:
     int m_id;
     double m_sizeSqm;
     double m_price;
-    std::string m_propertyType;
+    PropertyType m_propertyType;
     int m_bedrooms;
     int m_bathrooms;
     std::string m_place;
     bool m_available;
-    std::string m_listingType;
+    ListingType m_listingType;
 };
 
 #endif // PROPERTY_H
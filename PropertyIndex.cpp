@@ -0,0 +1,201 @@
+#include "PropertyIndex.h"
+#include <algorithm>
+#include <cctype>
+#include <limits>
+
+std::string PropertyIndex::normalize(const std::string &value) {
+    std::string key = value;
+    std::transform(key.begin(), key.end(), key.begin(),
+                   [](unsigned char c){ return static_cast<char>(std::tolower(c)); });
+    return key;
+}
+
+void PropertyIndex::removeFrom(std::unordered_map<std::string, IdSet> &index, const std::string &key, int id) {
+    auto it = index.find(key);
+    if(it == index.end())
+        return;
+    it->second.erase(id);
+    if(it->second.empty())
+        index.erase(it);
+}
+
+void PropertyIndex::insert(const Property &property) {
+    int id = property.getId();
+    m_byPlace[normalize(property.getPlace())].insert(id);
+    typeSet(property.getPropertyType()).insert(id);
+    listingSet(property.getListingType()).insert(id);
+    (property.getAvailability() ? m_available : m_unavailable).insert(id);
+    m_byPrice.emplace(property.getPrice(), id);
+    m_bySize.emplace(property.getSizeSqm(), id);
+    m_priceAndSize[id] = {property.getPrice(), property.getSizeSqm()};
+    if(property.getAvailability())
+        availableSet(property.getListingType()).emplace(property.getPrice(), id);
+}
+
+void PropertyIndex::erase(const Property &property) {
+    int id = property.getId();
+    removeFrom(m_byPlace, normalize(property.getPlace()), id);
+    typeSet(property.getPropertyType()).erase(id);
+    listingSet(property.getListingType()).erase(id);
+    (property.getAvailability() ? m_available : m_unavailable).erase(id);
+    m_byPrice.erase({property.getPrice(), id});
+    m_bySize.erase({property.getSizeSqm(), id});
+    m_priceAndSize.erase(id);
+    if(property.getAvailability())
+        availableSet(property.getListingType()).erase({property.getPrice(), id});
+}
+
+void PropertyIndex::clear() {
+    m_byPlace.clear();
+    for(auto &set : m_byType)
+        set.clear();
+    for(auto &set : m_byListing)
+        set.clear();
+    m_available.clear();
+    m_unavailable.clear();
+    m_byPrice.clear();
+    m_bySize.clear();
+    m_priceAndSize.clear();
+    for(auto &ordered : m_availableByListing)
+        ordered.clear();
+}
+
+void PropertyIndex::build(const std::vector<Property> &properties) {
+    clear();
+    m_available.reserve(properties.size());
+    m_priceAndSize.reserve(properties.size());
+
+    std::vector<std::pair<double, int>> byPrice, bySize;
+    std::array<std::vector<std::pair<double, int>>, LISTING_TYPE_COUNT> availableByListing;
+    byPrice.reserve(properties.size());
+    bySize.reserve(properties.size());
+    for(const auto &property : properties) {
+        int id = property.getId();
+        size_t listing = static_cast<size_t>(property.getListingType());
+        m_byPlace[normalize(property.getPlace())].insert(id);
+        typeSet(property.getPropertyType()).insert(id);
+        (property.getAvailability() ? m_available : m_unavailable).insert(id);
+        m_priceAndSize[id] = {property.getPrice(), property.getSizeSqm()};
+        byPrice.emplace_back(property.getPrice(), id);
+        bySize.emplace_back(property.getSizeSqm(), id);
+        if(property.getAvailability())
+            availableByListing[listing].emplace_back(property.getPrice(), id);
+        m_byListing[listing].insert(id);
+    }
+
+    // Sorted input + end hint makes each ordered-set insert amortised O(1)
+    auto fill = [](Ordered &ordered, std::vector<std::pair<double, int>> &entries) {
+        std::sort(entries.begin(), entries.end());
+        for(const auto &entry : entries)
+            ordered.insert(ordered.end(), entry);
+    };
+    fill(m_byPrice, byPrice);
+    fill(m_bySize, bySize);
+    for(size_t listing = 0; listing < LISTING_TYPE_COUNT; ++listing)
+        fill(m_availableByListing[listing], availableByListing[listing]);
+}
+
+std::vector<const PropertyIndex::IdSet*> PropertyIndex::filterSets(const PropertyQuery &query) const {
+    static const IdSet empty;
+    std::vector<const IdSet*> sets;
+
+    if(query.place) {
+        auto it = m_byPlace.find(normalize(*query.place));
+        sets.push_back(it == m_byPlace.end() ? &empty : &it->second);
+    }
+    if(query.propertyType)
+        sets.push_back(&m_byType[static_cast<size_t>(*query.propertyType)]);
+    if(query.listingType)
+        sets.push_back(&m_byListing[static_cast<size_t>(*query.listingType)]);
+    if(query.available)
+        sets.push_back(*query.available ? &m_available : &m_unavailable);
+
+    std::sort(sets.begin(), sets.end(),
+              [](const IdSet *a, const IdSet *b){ return a->size() < b->size(); });
+    return sets;
+}
+
+bool PropertyIndex::inAll(const std::vector<const IdSet*> &sets, int id) {
+    for(const IdSet *set : sets) {
+        if(!set->count(id))
+            return false;
+    }
+    return true;
+}
+
+std::vector<int> PropertyIndex::query(const PropertyQuery &query) const {
+    std::vector<const IdSet*> sets = filterSets(query);
+
+    std::vector<int> result;
+    if(sets.empty()) {
+        result.reserve(m_priceAndSize.size());
+        for(const auto &entry : m_priceAndSize)
+            result.push_back(entry.first);
+    } else {
+        // Walk the smallest set, probe the others
+        for(int id : *sets.front()) {
+            if(inAll(sets, id))
+                result.push_back(id);
+        }
+    }
+    std::sort(result.begin(), result.end());
+    return result;
+}
+
+std::vector<int> PropertyIndex::rangeQuery(const PropertyRange &range, const PropertyQuery &filter) const {
+    const double lowest = std::numeric_limits<double>::lowest();
+    const double highest = std::numeric_limits<double>::max();
+    double minPrice = range.minPrice.value_or(lowest);
+    double maxPrice = range.maxPrice.value_or(highest);
+    double minSize = range.minSizeSqm.value_or(lowest);
+    double maxSize = range.maxSizeSqm.value_or(highest);
+
+    bool walkSize = !range.minPrice && !range.maxPrice;
+    const Ordered &ordered = walkSize ? m_bySize : m_byPrice;
+    double from = walkSize ? minSize : minPrice;
+    double to = walkSize ? maxSize : maxPrice;
+
+    std::vector<const IdSet*> sets = filterSets(filter);
+    std::vector<int> result;
+    for(auto it = ordered.lower_bound({from, std::numeric_limits<int>::min()});
+        it != ordered.end() && it->first <= to; ++it) {
+        int id = it->second;
+        const auto &dims = m_priceAndSize.at(id);
+        if(dims.first < minPrice || dims.first > maxPrice) continue;
+        if(dims.second < minSize || dims.second > maxSize) continue;
+        if(inAll(sets, id))
+            result.push_back(id);
+    }
+    return result;
+}
+
+std::vector<int> PropertyIndex::cheapest(size_t count, const PropertyQuery &filter) const {
+    std::vector<const IdSet*> sets = filterSets(filter);
+    std::vector<int> result;
+    for(auto it = m_byPrice.begin(); it != m_byPrice.end() && result.size() < count; ++it) {
+        if(inAll(sets, it->second))
+            result.push_back(it->second);
+    }
+    return result;
+}
+
+std::vector<int> PropertyIndex::largest(size_t count, const PropertyQuery &filter) const {
+    std::vector<const IdSet*> sets = filterSets(filter);
+    std::vector<int> result;
+    for(auto it = m_bySize.rbegin(); it != m_bySize.rend() && result.size() < count; ++it) {
+        if(inAll(sets, it->second))
+            result.push_back(it->second);
+    }
+    return result;
+}
+
+std::vector<std::pair<double, int>> PropertyIndex::availableUpTo(ListingType listingType, double maxPrice,
+                                                                 size_t limit) const {
+    std::vector<std::pair<double, int>> result;
+    for(const auto &entry : m_availableByListing[static_cast<size_t>(listingType)]) {
+        if(entry.first > maxPrice || result.size() >= limit)
+            break;
+        result.push_back(entry);
+    }
+    return result;
+}
@@ -0,0 +1,91 @@
+#ifndef PROPERTYINDEX_H
+#define PROPERTYINDEX_H
+
+#include <array>
+#include <cstddef>
+#include <limits>
+#include <optional>
+#include <set>
+#include <utility>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+#include "Property.h"
+
+// Filters for CRMSystem::queryProperties; unset fields match anything.
+// The place is compared case-insensitively.
+struct PropertyQuery {
+    std::optional<std::string> place;
+    std::optional<PropertyType> propertyType;
+    std::optional<ListingType> listingType;
+    std::optional<bool> available;
+};
+
+// Inclusive price / size bounds for range searches; unset bounds are open.
+struct PropertyRange {
+    std::optional<double> minPrice;
+    std::optional<double> maxPrice;
+    std::optional<double> minSizeSqm;
+    std::optional<double> maxSizeSqm;
+};
+
+// Secondary indexes over the property catalog: one posting set of property IDs
+// per place, property type, listing type and availability value (the typed
+// ones in arrays indexed by the enum value), plus ordered
+// (value, id) sets over price and sizeSqm for range and top-k searches.
+class PropertyIndex {
+public:
+    void insert(const Property &property);
+    void erase(const Property &property);
+    void clear();
+    // Replace the contents with the given catalog (bulk load: sorted, hinted inserts)
+    void build(const std::vector<Property> &properties);
+
+    // IDs (ascending) of properties matching every filter set in the query.
+    // Walks the smallest matching posting set and probes the others.
+    std::vector<int> query(const PropertyQuery &query) const;
+
+    // IDs within the range that also pass the filter. Ordered by price, or by
+    // size when only size bounds are given (the ordered set that gets walked).
+    std::vector<int> rangeQuery(const PropertyRange &range, const PropertyQuery &filter = {}) const;
+
+    // Top-k: the 'count' cheapest / largest properties passing the filter
+    std::vector<int> cheapest(size_t count, const PropertyQuery &filter = {}) const;
+    std::vector<int> largest(size_t count, const PropertyQuery &filter = {}) const;
+
+    // (price, id) of available properties with the given listing type and
+    // price <= maxPrice, cheapest first, at most 'limit' of them (the walk
+    // stops there). Backs client budget matching.
+    std::vector<std::pair<double, int>> availableUpTo(ListingType listingType, double maxPrice,
+                                                      size_t limit = std::numeric_limits<size_t>::max()) const;
+
+private:
+    using IdSet = std::unordered_set<int>;
+
+    std::unordered_map<std::string, IdSet> m_byPlace;
+    std::array<IdSet, PROPERTY_TYPE_COUNT> m_byType;
+    std::array<IdSet, LISTING_TYPE_COUNT> m_byListing;
+    IdSet m_available;
+    IdSet m_unavailable;
+
+    using Ordered = std::set<std::pair<double, int>>;
+    Ordered m_byPrice;
+    Ordered m_bySize;
+    std::unordered_map<int, std::pair<double, double>> m_priceAndSize; // id -> (price, sizeSqm)
+    std::array<Ordered, LISTING_TYPE_COUNT> m_availableByListing;       // listing type -> (price, id)
+
+    // Posting sets selected by the query's filters, smallest first.
+    // An unknown place yields an empty set, so nothing matches.
+    std::vector<const IdSet*> filterSets(const PropertyQuery &query) const;
+    static bool inAll(const std::vector<const IdSet*> &sets, int id);
+
+    IdSet& typeSet(PropertyType type) { return m_byType[static_cast<size_t>(type)]; }
+    IdSet& listingSet(ListingType listing) { return m_byListing[static_cast<size_t>(listing)]; }
+    Ordered& availableSet(ListingType listing) { return m_availableByListing[static_cast<size_t>(listing)]; }
+
+    static std::string normalize(const std::string &value);
+    static void removeFrom(std::unordered_map<std::string, IdSet> &index, const std::string &key, int id);
+};
+
+#endif // PROPERTYINDEX_H
@@ -0,0 +1,335 @@
+#include "SQLiteStorage.h"
+#include "CSVTokenizer.h"
+#include "Exceptions.h"
+#include <algorithm>
+
+// Schema history; user_version records the last step applied. Append new
+// steps, never edit shipped ones: databases in the field are already past them.
+static const std::vector<Migration> MIGRATIONS = {
+    {1, "base tables",
+     "CREATE TABLE IF NOT EXISTS Agents (ID INTEGER PRIMARY KEY AUTOINCREMENT, FirstName TEXT, LastName TEXT, Phone TEXT, Email TEXT, StartDate TEXT, EndDate TEXT);"
+     "CREATE TABLE IF NOT EXISTS Clients (ID INTEGER PRIMARY KEY AUTOINCREMENT, FirstName TEXT, LastName TEXT, Phone TEXT, Email TEXT, IsMarried INTEGER, Budget REAL, BudgetType TEXT);"
+     "CREATE TABLE IF NOT EXISTS Properties (ID INTEGER PRIMARY KEY AUTOINCREMENT, SizeSqm REAL, Price REAL, Type TEXT, Bedrooms INTEGER, Bathrooms INTEGER, Place TEXT, Available INTEGER, ListingType TEXT);"
+     "CREATE TABLE IF NOT EXISTS Contracts (ID INTEGER PRIMARY KEY AUTOINCREMENT, PropertyId INTEGER, ClientId INTEGER, AgentId INTEGER, Price REAL, StartDate TEXT, EndDate TEXT, ContractType TEXT, IsActive INTEGER);"},
+    // SQLite cannot add a constraint to an existing table, so Contracts is
+    // rebuilt. "No reference" becomes NULL instead of -1, and so does a
+    // reference to a row that no longer exists, which older builds allowed.
+    // No ON DELETE action: CRMSystem applies its RemovalPolicy first, the
+    // constraint only stops a parent from disappearing under a contract.
+    {2, "foreign keys on Contracts",
+     "CREATE TABLE Contracts_v2 (ID INTEGER PRIMARY KEY AUTOINCREMENT,"
+     " PropertyId INTEGER REFERENCES Properties(ID), ClientId INTEGER REFERENCES Clients(ID),"
+     " AgentId INTEGER REFERENCES Agents(ID), Price REAL, StartDate TEXT, EndDate TEXT, ContractType TEXT, IsActive INTEGER);"
+     "INSERT INTO Contracts_v2 (ID, PropertyId, ClientId, AgentId, Price, StartDate, EndDate, ContractType, IsActive)"
+     " SELECT c.ID, (SELECT ID FROM Properties WHERE ID = c.PropertyId), (SELECT ID FROM Clients WHERE ID = c.ClientId),"
+     " (SELECT ID FROM Agents WHERE ID = c.AgentId), c.Price, c.StartDate, c.EndDate, c.ContractType, c.IsActive FROM Contracts c;"
+     "DROP TABLE Contracts;"
+     "ALTER TABLE Contracts_v2 RENAME TO Contracts;"},
+    // Contract lookups by party (also what the foreign key checks use when a
+    // parent is deleted) and the property filters CRMSystem offers; the
+    // trailing columns let the filters run from the index alone.
+    {3, "indexes for contract lookups and property filters",
+     "CREATE INDEX idx_contracts_agent ON Contracts(AgentId, IsActive);"
+     "CREATE INDEX idx_contracts_client ON Contracts(ClientId, IsActive);"
+     "CREATE INDEX idx_contracts_property ON Contracts(PropertyId, IsActive);"
+     "CREATE INDEX idx_properties_listing ON Properties(ListingType, Available, Price);"
+     "CREATE INDEX idx_properties_place ON Properties(Place, Type, Price);"
+     "CREATE INDEX idx_properties_type ON Properties(Type, Price);"
+     "CREATE INDEX idx_properties_price ON Properties(Price);"
+     "CREATE INDEX idx_clients_budget ON Clients(BudgetType, Budget);"}
+};
+
+// Upserts rather than INSERT OR REPLACE: REPLACE deletes the old row first,
+// which the foreign keys on Contracts would see as a parent going away.
+static const std::string SAVE_AGENT_SQL = "INSERT INTO Agents (ID, FirstName, LastName, Phone, Email, StartDate, EndDate) VALUES (?, ?, ?, ?, ?, ?, ?)"
+    " ON CONFLICT(ID) DO UPDATE SET FirstName = excluded.FirstName, LastName = excluded.LastName, Phone = excluded.Phone,"
+    " Email = excluded.Email, StartDate = excluded.StartDate, EndDate = excluded.EndDate;";
+static const std::string SAVE_CLIENT_SQL = "INSERT INTO Clients (ID, FirstName, LastName, Phone, Email, IsMarried, Budget, BudgetType) VALUES (?, ?, ?, ?, ?, ?, ?, ?)"
+    " ON CONFLICT(ID) DO UPDATE SET FirstName = excluded.FirstName, LastName = excluded.LastName, Phone = excluded.Phone,"
+    " Email = excluded.Email, IsMarried = excluded.IsMarried, Budget = excluded.Budget, BudgetType = excluded.BudgetType;";
+static const std::string SAVE_PROPERTY_SQL = "INSERT INTO Properties (ID, SizeSqm, Price, Type, Bedrooms, Bathrooms, Place, Available, ListingType) VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?)"
+    " ON CONFLICT(ID) DO UPDATE SET SizeSqm = excluded.SizeSqm, Price = excluded.Price, Type = excluded.Type, Bedrooms = excluded.Bedrooms,"
+    " Bathrooms = excluded.Bathrooms, Place = excluded.Place, Available = excluded.Available, ListingType = excluded.ListingType;";
+static const std::string SAVE_CONTRACT_SQL = "INSERT INTO Contracts (ID, PropertyId, ClientId, AgentId, Price, StartDate, EndDate, ContractType, IsActive) VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?)"
+    " ON CONFLICT(ID) DO UPDATE SET PropertyId = excluded.PropertyId, ClientId = excluded.ClientId, AgentId = excluded.AgentId, Price = excluded.Price,"
+    " StartDate = excluded.StartDate, EndDate = excluded.EndDate, ContractType = excluded.ContractType, IsActive = excluded.IsActive;";
+static const std::string REMOVE_AGENT_SQL = "DELETE FROM Agents WHERE ID = ?;";
+static const std::string REMOVE_CLIENT_SQL = "DELETE FROM Clients WHERE ID = ?;";
+static const std::string REMOVE_PROPERTY_SQL = "DELETE FROM Properties WHERE ID = ?;";
+static const std::string REMOVE_CONTRACT_SQL = "DELETE FROM Contracts WHERE ID = ?;";
+static const std::string LOAD_AGENTS_SQL = "SELECT ID, FirstName, LastName, Phone, Email, StartDate, EndDate FROM Agents ORDER BY ID;";
+static const std::string LOAD_CLIENTS_SQL = "SELECT ID, FirstName, LastName, Phone, Email, IsMarried, Budget, BudgetType FROM Clients ORDER BY ID;";
+static const std::string LOAD_PROPERTIES_SQL = "SELECT ID, SizeSqm, Price, Type, Bedrooms, Bathrooms, Place, Available, ListingType FROM Properties ORDER BY ID;";
+static const std::string COUNT_AGENTS_SQL = "SELECT COUNT(*) FROM Agents;";
+static const std::string COUNT_CLIENTS_SQL = "SELECT COUNT(*) FROM Clients;";
+static const std::string COUNT_PROPERTIES_SQL = "SELECT COUNT(*) FROM Properties;";
+static const std::string COUNT_CONTRACTS_SQL = "SELECT COUNT(*) FROM Contracts;";
+static const std::string LOAD_CONTRACTS_SQL = "SELECT ID, PropertyId, ClientId, AgentId, Price, StartDate, EndDate, ContractType, IsActive FROM Contracts ORDER BY ID;";
+
+// Dates are stored as "YYYY-MM-DD"; an empty date is NULL. 'storage' holds
+// the text until the statement has run.
+static void bindDate(Statement &stmt, int index, const Date &date, std::string &storage) {
+    if(date.isEmpty()) {
+        stmt.bindNull(index);
+        return;
+    }
+    storage.clear();
+    date.appendTo(storage);
+    stmt.bind(index, storage);
+}
+
+static Date columnDate(const Statement &stmt, int column) {
+    return CSVTokenizer::toDate(stmt.getTextView(column));
+}
+
+// Contract references: CRMSystem's -1 ("none") is NULL in the database, the
+// only value a foreign key column accepts for a missing parent
+static void bindReference(Statement &stmt, int index, int id) {
+    if(id < 0)
+        stmt.bindNull(index);
+    else
+        stmt.bind(index, id);
+}
+
+static int columnReference(const Statement &stmt, int column) {
+    return stmt.isNull(column) ? -1 : stmt.getInt(column);
+}
+
+// Rows per transaction in the bulk inserts
+static const size_t DEFAULT_BATCH_SIZE = 10000;
+
+SQLiteStorage::SQLiteStorage(const std::string &path, const DatabaseConfig &config, size_t readers)
+    : m_pool(path, readers, config), m_writer(m_pool.acquireWriter()),
+      m_owner(std::this_thread::get_id()), m_batchSize(DEFAULT_BATCH_SIZE)
+{
+    m_writer->migrate(MIGRATIONS);
+}
+
+SQLiteStorage::~SQLiteStorage() = default;
+
+template <typename Query>
+auto SQLiteStorage::read(Query query) {
+    // Only the owner's transactions are visible to it; other threads never
+    // look at the writer's state
+    if(std::this_thread::get_id() == m_owner && m_writer->inTransaction())
+        return query(*m_writer);
+    ConnectionPool::Lease reader = m_pool.acquireReader();
+    return query(*reader);
+}
+
+void SQLiteStorage::save(const Agent &a) {
+    std::string start, end;
+    Statement &stmt = m_writer->prepare(SAVE_AGENT_SQL);
+    stmt.bind(1, a.getId())
+        .bind(2, a.getFirstName())
+        .bind(3, a.getLastName())
+        .bind(4, a.getPhone())
+        .bind(5, a.getEmail());
+    bindDate(stmt, 6, a.getStartDate(), start);
+    bindDate(stmt, 7, a.getEndDate(), end);
+    stmt.execute();
+}
+
+void SQLiteStorage::save(const Client &c) {
+    m_writer->prepare(SAVE_CLIENT_SQL)
+        .bind(1, c.getId())
+        .bind(2, c.getFirstName())
+        .bind(3, c.getLastName())
+        .bind(4, c.getPhone())
+        .bind(5, c.getEmail())
+        .bind(6, c.getIsMarried())
+        .bind(7, c.getBudget())
+        .bind(8, toString(c.getBudgetType()))
+        .execute();
+}
+
+void SQLiteStorage::save(const Property &p) {
+    m_writer->prepare(SAVE_PROPERTY_SQL)
+        .bind(1, p.getId())
+        .bind(2, p.getSizeSqm())
+        .bind(3, p.getPrice())
+        .bind(4, toString(p.getPropertyType()))
+        .bind(5, p.getBedrooms())
+        .bind(6, p.getBathrooms())
+        .bind(7, p.getPlace())
+        .bind(8, p.getAvailability())
+        .bind(9, toString(p.getListingType()))
+        .execute();
+}
+
+void SQLiteStorage::save(const Contract &ct) {
+    std::string start, end;
+    Statement &stmt = m_writer->prepare(SAVE_CONTRACT_SQL);
+    stmt.bind(1, ct.getId());
+    bindReference(stmt, 2, ct.getPropertyId());
+    bindReference(stmt, 3, ct.getClientId());
+    bindReference(stmt, 4, ct.getAgentId());
+    stmt.bind(5, ct.getPrice());
+    bindDate(stmt, 6, ct.getStartDate(), start);
+    bindDate(stmt, 7, ct.getEndDate(), end);
+    stmt.bind(8, toString(ct.getContractType()))
+        .bind(9, ct.getIsActive())
+        .execute();
+}
+
+void SQLiteStorage::remove(const char *entity, int id) {
+    std::string name(entity);
+    const std::string &sql = name == "agent" ? REMOVE_AGENT_SQL
+                           : name == "client" ? REMOVE_CLIENT_SQL
+                           : name == "property" ? REMOVE_PROPERTY_SQL
+                           : REMOVE_CONTRACT_SQL;
+    m_writer->prepare(sql).bind(1, id).execute();
+}
+
+void SQLiteStorage::setBatchSize(size_t rows) {
+    m_batchSize = rows == 0 ? 1 : rows;
+}
+
+template <typename T>
+size_t SQLiteStorage::insertBatched(const std::vector<T> &items) {
+    size_t written = 0;
+    while(written < items.size()) {
+        size_t end = std::min(items.size(), written + m_batchSize);
+        Transaction batch(*m_writer);
+        for(size_t i = written; i < end; ++i) {
+            save(items[i]);
+        }
+        batch.commit();
+        written = end;
+    }
+    return written;
+}
+
+size_t SQLiteStorage::insertAgents(const std::vector<Agent> &agents) {
+    return insertBatched(agents);
+}
+
+size_t SQLiteStorage::insertClients(const std::vector<Client> &clients) {
+    return insertBatched(clients);
+}
+
+size_t SQLiteStorage::insertProperties(const std::vector<Property> &properties) {
+    return insertBatched(properties);
+}
+
+size_t SQLiteStorage::insertContracts(const std::vector<Contract> &contracts) {
+    return insertBatched(contracts);
+}
+
+void SQLiteStorage::load(std::vector<Agent> &agents, std::vector<Client> &clients,
+                         std::vector<Property> &properties, std::vector<Contract> &contracts) {
+    scanAgents([&](Agent &a) { agents.push_back(std::move(a)); });
+    scanClients([&](Client &c) { clients.push_back(std::move(c)); });
+    scanProperties([&](Property &p) { properties.push_back(std::move(p)); });
+    scanContracts([&](Contract &ct) { contracts.push_back(std::move(ct)); });
+}
+
+size_t SQLiteStorage::scanAgents(const std::function<void(Agent&)> &visit) {
+    return read([&](DatabaseManager &db) {
+        size_t rows = 0;
+        Statement &agentRows = db.prepare(LOAD_AGENTS_SQL);
+        while(agentRows.step()) {
+            Agent a;
+            a.setId(agentRows.getInt(0));
+            a.setFirstName(agentRows.getText(1));
+            a.setLastName(agentRows.getText(2));
+            a.setPhone(agentRows.getText(3));
+            a.setEmail(agentRows.getText(4));
+            a.setStartDate(columnDate(agentRows, 5));
+            a.setEndDate(columnDate(agentRows, 6));
+            visit(a);
+            ++rows;
+        }
+        return rows;
+    });
+}
+
+size_t SQLiteStorage::scanClients(const std::function<void(Client&)> &visit) {
+    return read([&](DatabaseManager &db) {
+        size_t rows = 0;
+        Statement &clientRows = db.prepare(LOAD_CLIENTS_SQL);
+        while(clientRows.step()) {
+            Client c;
+            c.setId(clientRows.getInt(0));
+            c.setFirstName(clientRows.getText(1));
+            c.setLastName(clientRows.getText(2));
+            c.setPhone(clientRows.getText(3));
+            c.setEmail(clientRows.getText(4));
+            c.setIsMarried(clientRows.getBool(5));
+            c.setBudget(clientRows.getDouble(6));
+            c.setBudgetType(clientRows.getTextView(7));
+            visit(c);
+            ++rows;
+        }
+        return rows;
+    });
+}
+
+size_t SQLiteStorage::scanProperties(const std::function<void(Property&)> &visit) {
+    return read([&](DatabaseManager &db) {
+        size_t rows = 0;
+        Statement &propertyRows = db.prepare(LOAD_PROPERTIES_SQL);
+        while(propertyRows.step()) {
+            Property p;
+            p.setId(propertyRows.getInt(0));
+            p.setSizeSqm(propertyRows.getDouble(1));
+            p.setPrice(propertyRows.getDouble(2));
+            p.setPropertyType(propertyRows.getTextView(3));
+            p.setBedrooms(propertyRows.getInt(4));
+            p.setBathrooms(propertyRows.getInt(5));
+            p.setPlace(propertyRows.getText(6));
+            p.setAvailability(propertyRows.getBool(7));
+            p.setListingType(propertyRows.getTextView(8));
+            visit(p);
+            ++rows;
+        }
+        return rows;
+    });
+}
+
+size_t SQLiteStorage::scanContracts(const std::function<void(Contract&)> &visit) {
+    return read([&](DatabaseManager &db) {
+        size_t rows = 0;
+        Statement &contractRows = db.prepare(LOAD_CONTRACTS_SQL);
+        while(contractRows.step()) {
+            Contract ct;
+            ct.setId(contractRows.getInt(0));
+            ct.setPropertyId(columnReference(contractRows, 1));
+            ct.setClientId(columnReference(contractRows, 2));
+            ct.setAgentId(columnReference(contractRows, 3));
+            ct.setPrice(contractRows.getDouble(4));
+            ct.setStartDate(columnDate(contractRows, 5));
+            ct.setEndDate(columnDate(contractRows, 6));
+            ct.setContractType(contractRows.getTextView(7));
+            ct.setIsActive(contractRows.getBool(8));
+            visit(ct);
+            ++rows;
+        }
+        return rows;
+    });
+}
+
+size_t SQLiteStorage::countRows(const char *entity) {
+    std::string name(entity);
+    const std::string &sql = name == "agent" ? COUNT_AGENTS_SQL
+                           : name == "client" ? COUNT_CLIENTS_SQL
+                           : name == "property" ? COUNT_PROPERTIES_SQL
+                           : COUNT_CONTRACTS_SQL;
+    return read([&](DatabaseManager &db) {
+        Statement &stmt = db.prepare(sql);
+        stmt.step();
+        size_t rows = static_cast<size_t>(stmt.getInt64(0));
+        stmt.reset();
+        return rows;
+    });
+}
+
+void SQLiteStorage::clear() {
+    // Contracts first: they reference the other three
+    Transaction tx(*m_writer);
+    m_writer->prepare("DELETE FROM Contracts;").execute();
+    m_writer->prepare("DELETE FROM Properties;").execute();
+    m_writer->prepare("DELETE FROM Clients;").execute();
+    m_writer->prepare("DELETE FROM Agents;").execute();
+    tx.commit();
+}
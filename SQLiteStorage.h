@@ -0,0 +1,99 @@
+#ifndef SQLITESTORAGE_H
+#define SQLITESTORAGE_H
+
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <thread>
+#include <vector>
+#include "ConnectionPool.h"
+#include "DatabaseManager.h"
+#include "Transaction.h"
+#include "Agent.h"
+#include "Client.h"
+#include "Property.h"
+#include "Contract.h"
+
+// CRMSystem persistence in a SQLite database (StorageFormat::SQLite).
+//
+// The four tables are read once at startup; after that every add, modify and
+// remove is written through immediately, so the database is always current
+// and needs neither the journal nor checkpoints. CRMSystem still keeps every
+// row in memory and answers lookups and queries from its own indexes, so
+// this backend does not lower memory use: the dataset must fit in RAM as it
+// does for the CSV and snapshot formats. SQLite's indexes serve the tools
+// that read the database directly (see tools/). All statements come from
+// DatabaseManager's statement cache and are reused with bound parameters.
+// Opening a database brings its schema (PRAGMA user_version) up to date in
+// place; contracts reference their parties through foreign keys, with -1
+// stored as NULL. Errors throw DatabaseException.
+//
+// Connections come from a ConnectionPool. Writes (save, remove, insert*,
+// clear, and Transactions on connection()) use its single writer, one
+// thread at a time. Reads (load, scan*, countRows) check out a read-only
+// connection, so in WAL mode they run alongside writes from other threads
+// and see the last committed state. The exception is a read made by the
+// thread that created the storage while a transaction is open on the
+// writer: it runs on the writer, so it sees that transaction's rows.
+class SQLiteStorage {
+public:
+    explicit SQLiteStorage(const std::string &path, const DatabaseConfig &config = DatabaseConfig::balanced(),
+                           size_t readers = 2);
+    ~SQLiteStorage();
+
+    SQLiteStorage(const SQLiteStorage&) = delete;
+    SQLiteStorage& operator=(const SQLiteStorage&) = delete;
+
+    void load(std::vector<Agent> &agents, std::vector<Client> &clients,
+              std::vector<Property> &properties, std::vector<Contract> &contracts);
+
+    // Stream one table in ID order without holding it in memory; 'visit'
+    // may move from the row it is given. Returns the rows visited.
+    size_t scanAgents(const std::function<void(Agent&)> &visit);
+    size_t scanClients(const std::function<void(Client&)> &visit);
+    size_t scanProperties(const std::function<void(Property&)> &visit);
+    size_t scanContracts(const std::function<void(Contract&)> &visit);
+
+    // 'entity' as for remove()
+    size_t countRows(const char *entity);
+    // Delete every row of all four tables in one transaction
+    void clear();
+
+    // Insert the row with the entity's ID, or update it if it exists
+    void save(const Agent &agent);
+    void save(const Client &client);
+    void save(const Property &property);
+    void save(const Contract &contract);
+
+    // 'entity' is "agent", "client", "property" or "contract"
+    void remove(const char *entity, int id);
+
+    // Bulk insert-or-replace, committed in transactions of batchSize rows
+    // (one fsync per batch instead of per row). Returns the rows written.
+    size_t insertAgents(const std::vector<Agent> &agents);
+    size_t insertClients(const std::vector<Client> &clients);
+    size_t insertProperties(const std::vector<Property> &properties);
+    size_t insertContracts(const std::vector<Contract> &contracts);
+    void setBatchSize(size_t rows);
+    size_t getBatchSize() const { return m_batchSize; }
+
+    // The writer, for grouping several writes into one Transaction
+    DatabaseManager& connection() { return *m_writer; }
+    // A pooled read-only connection for ad hoc queries, from any thread
+    ConnectionPool::Lease reader() { return m_pool.acquireReader(); }
+    ConnectionPool::Stats poolStats() const { return m_pool.getStats(); }
+
+private:
+    template <typename T>
+    size_t insertBatched(const std::vector<T> &items);
+    // Run 'query' on the connection a read should use (see the class comment)
+    template <typename Query>
+    auto read(Query query);
+
+    ConnectionPool m_pool;
+    ConnectionPool::Lease m_writer; // held for the storage's lifetime
+    std::thread::id m_owner;
+    size_t m_batchSize;
+};
+
+#endif // SQLITESTORAGE_H
@@ -0,0 +1,98 @@
+#include "Statement.h"
+#include "Exceptions.h"
+
+Statement::Statement(sqlite3 *db, const std::string &sql)
+    : m_db(db), m_stmt(nullptr), m_sql(sql)
+{
+    check(sqlite3_prepare_v2(m_db, sql.c_str(), static_cast<int>(sql.size() + 1), &m_stmt, nullptr), "prepare");
+}
+
+Statement::~Statement() {
+    sqlite3_finalize(m_stmt);
+}
+
+void Statement::check(int rc, const char *operation) const {
+    if(rc != SQLITE_OK && rc != SQLITE_ROW && rc != SQLITE_DONE)
+        throw DatabaseException(std::string(operation) + " \"" + m_sql + "\"", sqlite3_errmsg(m_db));
+}
+
+Statement& Statement::bind(int index, const std::string &value) {
+    return bind(index, std::string_view(value));
+}
+
+Statement& Statement::bind(int index, std::string_view value) {
+    check(sqlite3_bind_text(m_stmt, index, value.data(), static_cast<int>(value.size()), SQLITE_STATIC), "bind");
+    return *this;
+}
+
+Statement& Statement::bind(int index, int value) {
+    check(sqlite3_bind_int(m_stmt, index, value), "bind");
+    return *this;
+}
+
+Statement& Statement::bind(int index, std::int64_t value) {
+    check(sqlite3_bind_int64(m_stmt, index, static_cast<sqlite3_int64>(value)), "bind");
+    return *this;
+}
+
+Statement& Statement::bind(int index, double value) {
+    check(sqlite3_bind_double(m_stmt, index, value), "bind");
+    return *this;
+}
+
+Statement& Statement::bindNull(int index) {
+    check(sqlite3_bind_null(m_stmt, index), "bind");
+    return *this;
+}
+
+bool Statement::step() {
+    int rc = sqlite3_step(m_stmt);
+    if(rc == SQLITE_ROW)
+        return true;
+    if(rc != SQLITE_DONE) {
+        // Reset first so the statement is reusable, then report the step error
+        sqlite3_reset(m_stmt);
+        throw DatabaseException("step \"" + m_sql + "\"", sqlite3_errmsg(m_db));
+    }
+    return false;
+}
+
+int Statement::execute() {
+    while(step()) {
+    }
+    int changed = sqlite3_changes(m_db);
+    reset();
+    return changed;
+}
+
+void Statement::reset() {
+    sqlite3_reset(m_stmt);
+    sqlite3_clear_bindings(m_stmt);
+}
+
+bool Statement::isNull(int column) const {
+    return sqlite3_column_type(m_stmt, column) == SQLITE_NULL;
+}
+
+int Statement::getInt(int column) const {
+    return sqlite3_column_int(m_stmt, column);
+}
+
+std::int64_t Statement::getInt64(int column) const {
+    return static_cast<std::int64_t>(sqlite3_column_int64(m_stmt, column));
+}
+
+double Statement::getDouble(int column) const {
+    return sqlite3_column_double(m_stmt, column);
+}
+
+std::string Statement::getText(int column) const {
+    return std::string(getTextView(column));
+}
+
+std::string_view Statement::getTextView(int column) const {
+    const unsigned char *text = sqlite3_column_text(m_stmt, column);
+    if(!text)
+        return std::string_view();
+    return std::string_view(reinterpret_cast<const char*>(text), static_cast<size_t>(sqlite3_column_bytes(m_stmt, column)));
+}
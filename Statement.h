@@ -0,0 +1,59 @@
+#ifndef STATEMENT_H
+#define STATEMENT_H
+
+#include <sqlite3.h>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+// A compiled SQLite statement: typed parameter binding (1-based, like
+// sqlite3_bind_*), row iteration and column access (0-based). Statements
+// are normally owned by DatabaseManager's cache and reused; the manager
+// reset()s them each time they are handed out. Errors throw DatabaseException.
+class Statement {
+public:
+    Statement(sqlite3 *db, const std::string &sql);
+    ~Statement();
+
+    Statement(const Statement&) = delete;
+    Statement& operator=(const Statement&) = delete;
+
+    // Text is bound without copying: it must outlive the next step()
+    Statement& bind(int index, const std::string &value);
+    Statement& bind(int index, std::string &&value) = delete;
+    Statement& bind(int index, std::string_view value);
+    Statement& bind(int index, const char *value) { return bind(index, std::string_view(value)); }
+    Statement& bind(int index, int value);
+    Statement& bind(int index, std::int64_t value);
+    Statement& bind(int index, double value);
+    Statement& bind(int index, bool value) { return bind(index, value ? 1 : 0); }
+    Statement& bindNull(int index);
+
+    // Advance to the next row: true while a row is available, false when done
+    bool step();
+    // Run a statement that returns no rows, then reset it; returns the
+    // number of rows it changed
+    int execute();
+    // Rewind and clear the bindings so the statement can be run again
+    void reset();
+
+    bool isNull(int column) const;
+    int getInt(int column) const;
+    std::int64_t getInt64(int column) const;
+    double getDouble(int column) const;
+    bool getBool(int column) const { return getInt(column) != 0; }
+    std::string getText(int column) const; // "" for NULL
+    // View into SQLite's buffer, valid until the next step()/reset()
+    std::string_view getTextView(int column) const;
+
+    const std::string& sql() const { return m_sql; }
+
+private:
+    void check(int rc, const char *operation) const;
+
+    sqlite3 *m_db;
+    sqlite3_stmt *m_stmt;
+    std::string m_sql;
+};
+
+#endif // STATEMENT_H
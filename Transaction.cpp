@@ -0,0 +1,47 @@
+#include "Transaction.h"
+
+Transaction::Transaction(DatabaseManager &db)
+    : m_db(db), m_open(false)
+{
+    if(m_db.transactionDepth == 0) {
+        m_db.prepare("BEGIN IMMEDIATE;").execute();
+    } else {
+        // Named by depth, so the statement cache holds one set per level
+        m_savepoint = "crm_savepoint_" + std::to_string(m_db.transactionDepth);
+        m_db.prepare("SAVEPOINT " + m_savepoint + ";").execute();
+    }
+    ++m_db.transactionDepth;
+    m_open = true;
+}
+
+Transaction::~Transaction() {
+    if(!m_open)
+        return;
+    try {
+        rollback();
+    } catch (const std::exception&) {
+        // Unwinding already: SQLite rolls back whatever is left when the connection closes
+    }
+}
+
+void Transaction::commit() {
+    if(!m_open)
+        return;
+    m_db.prepare(isSavepoint() ? "RELEASE " + m_savepoint + ";" : std::string("COMMIT;")).execute();
+    m_open = false;
+    --m_db.transactionDepth;
+}
+
+void Transaction::rollback() {
+    if(!m_open)
+        return;
+    m_open = false;
+    --m_db.transactionDepth;
+    if(isSavepoint()) {
+        m_db.prepare("ROLLBACK TO " + m_savepoint + ";").execute();
+        m_db.prepare("RELEASE " + m_savepoint + ";").execute();
+    } else if(!sqlite3_get_autocommit(m_db.handle())) {
+        // (SQLite may already have rolled back by itself after some errors)
+        m_db.prepare("ROLLBACK;").execute();
+    }
+}
@@ -0,0 +1,31 @@
+#ifndef TRANSACTION_H
+#define TRANSACTION_H
+
+#include <string>
+#include "DatabaseManager.h"
+
+// RAII transaction on a DatabaseManager connection. The outermost one runs
+// BEGIN IMMEDIATE ... COMMIT; one opened while another is active becomes a
+// SAVEPOINT, so a failure inside it rolls back only its own writes and the
+// enclosing transaction can carry on. Anything not commit()ted is rolled
+// back on destruction. Errors throw DatabaseException.
+class Transaction {
+public:
+    explicit Transaction(DatabaseManager &db);
+    ~Transaction();
+
+    Transaction(const Transaction&) = delete;
+    Transaction& operator=(const Transaction&) = delete;
+
+    void commit();
+    void rollback();
+
+    bool isSavepoint() const { return !m_savepoint.empty(); }
+
+private:
+    DatabaseManager &m_db;
+    std::string m_savepoint; // empty for the outermost transaction
+    bool m_open;
+};
+
+#endif // TRANSACTION_H
@@ -3,6 +3,7 @@
 #include <functional>
 #include <limits>
 #include <cctype>  // for isdigit()
+#include <cstdlib> // for atoi()
 #include <sstream>
 #include <algorithm> // for transform
 #include "CRMSystem.h"
@@ -12,7 +13,6 @@
 #include "Contract.h"
 #include "Exceptions.h"
 #include "Date.h"
-#include "DatabaseManager.h"
 
 
 using namespace std;
@@ -295,15 +295,42 @@ string enterContractEndDate(){
 //------------------------------
 // Main Application
 //------------------------------
-int main() {
-    CRMSystem system;
-    DatabaseManager db("real_estate.db"); //DatabaseManager db("realestate.db");
-    // Initialize the database and create tables if they don't exist
-        // Step 3: Create tables at startup
-        db.execute("CREATE TABLE IF NOT EXISTS Agents (ID INTEGER PRIMARY KEY AUTOINCREMENT, FirstName TEXT, LastName TEXT, Phone TEXT, Email TEXT, StartDate TEXT, EndDate TEXT);");
-        db.execute("CREATE TABLE IF NOT EXISTS Clients (ID INTEGER PRIMARY KEY AUTOINCREMENT, FirstName TEXT, LastName TEXT, Phone TEXT, Email TEXT, IsMarried INTEGER, Budget REAL, BudgetType TEXT);");
-        db.execute("CREATE TABLE IF NOT EXISTS Properties (ID INTEGER PRIMARY KEY AUTOINCREMENT, SizeSqm REAL, Price REAL, Type TEXT, Bedrooms INTEGER, Bathrooms INTEGER, Place TEXT, Available INTEGER, ListingType TEXT);");
-        db.execute("CREATE TABLE IF NOT EXISTS Contracts (ID INTEGER PRIMARY KEY AUTOINCREMENT, PropertyId INTEGER, ClientId INTEGER, AgentId INTEGER, Price REAL, StartDate TEXT, EndDate TEXT, ContractType TEXT, IsActive INTEGER);");
+int main(int argc, char *argv[]) {
+    // Storage selection: --snapshot loads/saves crm_data.snapshot instead of the CSV files,
+    // --sqlite keeps everything in real_estate.db (changes are written immediately),
+    // --db-profile=defaults|durable|balanced|bulk picks its SQLite settings (default balanced),
+    // --csv-to-snapshot converts the CSV files into that snapshot and exits.
+    // --checkpoint-interval=SECONDS sets how often changes are saved in the background (0 = only on exit)
+    StorageFormat storageFormat = StorageFormat::CSV;
+    int checkpointSeconds = 30;
+    DatabaseConfig databaseConfig = DatabaseConfig::balanced();
+    for (int i = 1; i < argc; ++i) {
+        string arg = argv[i];
+        if (arg == "--snapshot") {
+            storageFormat = StorageFormat::Snapshot;
+        } else if (arg == "--sqlite") {
+            storageFormat = StorageFormat::SQLite;
+        } else if (arg.rfind("--db-profile=", 0) == 0) {
+            try {
+                databaseConfig = DatabaseConfig::fromProfile(arg.substr(arg.find('=') + 1));
+            } catch (const ValidationException& e) {
+                cerr << e.what() << "\n";
+                return 1;
+            }
+        } else if (arg.rfind("--checkpoint-interval=", 0) == 0) {
+            checkpointSeconds = atoi(arg.c_str() + arg.find('=') + 1);
+        } else if (arg == "--csv-to-snapshot") {
+            CRMSystem::convertCSVToSnapshot("crm_data.snapshot");
+            cout << "CSV data converted to crm_data.snapshot.\n";
+            return 0;
+        }
+    }
+
+    CRMSystem system(storageFormat, databaseConfig);
+    // Interactive edits are rare: make each one durable as soon as it is made
+    system.setJournalGroupCommit(1);
+    if (checkpointSeconds > 0)
+        system.startCheckpointer(std::chrono::seconds(checkpointSeconds));
     int mainChoice = 0;
 
     while (true) {
@@ -380,13 +407,6 @@ int main() {
 
                     try {
                         system.addAgent(a);
-                        //system.addAgent(a) into the database;
-                        // Inside Add Agent (mainChoice == 1 and choice == 1)
-                        std::stringstream query;
-                        query << "INSERT INTO Agents (FirstName, LastName, Phone, Email, StartDate, EndDate) VALUES ('"
-                            << firstName << "', '" << lastName << "', '" << phone << "', '" << email << "', '"
-                            << startDate.toString() << "', '" << endDate.toString() << "');";
-                        db.execute(query.str()); 
                         
                         
                         cout << "Agent added successfully.\n";
@@ -403,13 +423,21 @@ int main() {
                 }
                 else if (choice == 2) {
                     int id = getValidInputNumber<int>("Enter agent ID to remove: ");
-                    if (system.removeAgent(id)){
-                        stringstream deleteQuery;
-                        deleteQuery << "DELETE FROM Agents WHERE ID = " << id << ";";
-                        db.execute(deleteQuery.str());
-                        cout << "Agent removed successfully.\n";
-                    }else
-                        cout << "Agent not found.\n";
+                    try {
+                        if (system.removeAgent(id)){
+                            cout << "Agent removed successfully.\n";
+                        }else
+                            cout << "Agent not found.\n";
+                    }
+                    catch (const ReferentialIntegrityException& e) {
+                        cerr << "Error: " << e.what() << "\n";
+                    }
+                    catch (const CRMException& e) {
+                        cerr << "CRM Error: " << e.what() << "\n";
+                    }
+                    catch (const std::exception& e) {
+                        cerr << "Unexpected error: " << e.what() << "\n";
+                    }
                 }
                 else if (choice == 3) {
                     int id = getValidInputNumber<int>("Enter agent ID to search: ");
@@ -469,17 +497,6 @@ int main() {
 
                     if (system.modifyAgent(existing)){
                         cout << "Agent modified successfully.\n";
-                        //system.modifyAgent(existing) into the database;
-                        stringstream updateQuery;
-                        updateQuery << "UPDATE Agents SET "
-                                    << "FirstName = '" << existing.getFirstName() << "', "
-                                    << "LastName = '" << existing.getLastName() << "', "
-                                    << "Phone = '" << existing.getPhone() << "', "
-                                    << "Email = '" << existing.getEmail() << "', "
-                                    << "StartDate = '" << existing.getStartDate().toString() << "', "
-                                    << "EndDate = '" << existing.getEndDate().toString() << "' "
-                                    << "WHERE ID = " << id << ";";
-                        db.execute(updateQuery.str());
                     }else
                         cout << "Modification failed.\n";
                     }
@@ -563,13 +580,6 @@ int main() {
                     c.setBudgetType(budgetType);
                     try {
                         system.addClient(c);
-                        //system.addClient(c) into the database;
-                        // Inside Add Client (mainChoice == 2 and choice == 1)
-                        std::stringstream cquery;
-                        cquery << "INSERT INTO Clients (FirstName, LastName, Phone, Email, IsMarried, Budget, BudgetType) VALUES ('"
-                            << firstName << "', '" << lastName << "', '" << phone << "', '" << email << "', "
-                            << married << ", " << budget << ", '" << budgetType << "');";
-                        db.execute(cquery.str());
 
 
                         cout << "Client added successfully.\n";
@@ -586,13 +596,21 @@ int main() {
                 }
                 else if (choice == 2) {
                     int id = getValidInputNumber<int>("Enter client ID to remove: ");
-                    if (system.removeClient(id)){
-                        std::stringstream query;
-                        query << "DELETE FROM Clients WHERE ID = " << id << ";";
-                        db.execute(query.str());
-                        cout << "Client removed successfully.\n";
-                    }else
-                        cout << "Client not found.\n";
+                    try {
+                        if (system.removeClient(id)){
+                            cout << "Client removed successfully.\n";
+                        }else
+                            cout << "Client not found.\n";
+                    }
+                    catch (const ReferentialIntegrityException& e) {
+                        cerr << "Error: " << e.what() << "\n";
+                    }
+                    catch (const CRMException& e) {
+                        cerr << "CRM Error: " << e.what() << "\n";
+                    }
+                    catch (const std::exception& e) {
+                        cerr << "Unexpected error: " << e.what() << "\n";
+                    }
                 }
                 else if (choice == 3) {
                     int id = getValidInputNumber<int>("Enter client ID to search: ");
@@ -650,19 +668,6 @@ int main() {
                         existing.setBudgetType(budgetType);
                         
                         if (system.modifyClient(existing)){
-                            //system.modifyClient(existing) into the database;
-                            std::stringstream updateQuery;
-                            updateQuery << "UPDATE Clients SET "
-                                        << "FirstName = '" << existing.getFirstName()
-                                        << "', LastName = '" << existing.getLastName()
-                                        << "', Phone = '" << existing.getPhone()
-                                        << "', Email = '" << existing.getEmail()
-                                        << "', IsMarried = " << existing.getIsMarried()
-                                        << ", Budget = " << existing.getBudget()
-                                        << ", BudgetType = '" << existing.getBudgetType()
-                                        << "' WHERE ID = " << id << ";";
-                        
-                            db.execute(updateQuery.str());
                             cout << "Client modified successfully.\n";
                         }else
                             cout << "Modification failed.\n";
@@ -732,7 +737,7 @@ int main() {
                     p.setPropertyType(type);
 
                     //We will not allow the user to input bedrooms and bathrooms if the property is land. ~Jad
-                    if (p.getPropertyType() != "land") {
+                    if (p.getPropertyType() != PropertyType::Land) {
                         int bedrooms = getValidInputNumber<int>("Enter number of bedrooms: ");
                         while (bedrooms <0)
                         {
@@ -746,7 +751,7 @@ int main() {
                     }
 
                     //We will not allow the user to input bedrooms and bathrooms if the property is land. ~Jad
-                    if (p.getPropertyType() != "land") {
+                    if (p.getPropertyType() != PropertyType::Land) {
                         int bathrooms = getValidInputNumber<int>("Enter number of bathrooms: ");
                         while (bathrooms <0)
                         {
@@ -784,13 +789,6 @@ int main() {
                     
                     try {
                         system.addProperty(p);
-                        //system.addProperty(p) into the database;
-                        // Inside Add Property (mainChoice == 3 and choice == 1)
-                        std::stringstream pquery;
-                        pquery << "INSERT INTO Properties (SizeSqm, Price, Type, Bedrooms, Bathrooms, Place, Available, ListingType) VALUES ("
-                               << size << ", " << price << ", '" << type << "', " << p.getBedrooms() << ", " << p.getBathrooms() << ", '"
-                               << place << "', " << availInt << ", '" << listing << "');";
-                        db.execute(pquery.str());
                         cout << "Property added successfully.\n";
                     }
                     catch (const ValidationException& e) {
@@ -805,13 +803,21 @@ int main() {
                 }
                 else if (choice == 2) {
                     int id = getValidInputNumber<int>("Enter property ID to remove: ");
-                    if (system.removeProperty(id)){
-                        std::stringstream query;
-                        query << "DELETE FROM Properties WHERE ID = " << id << ";";
-                        db.execute(query.str());
-                        cout << "Property removed successfully.\n";
-                    }else
-                        cout << "Property not found.\n";
+                    try {
+                        if (system.removeProperty(id)){
+                            cout << "Property removed successfully.\n";
+                        }else
+                            cout << "Property not found.\n";
+                    }
+                    catch (const ReferentialIntegrityException& e) {
+                        cerr << "Error: " << e.what() << "\n";
+                    }
+                    catch (const CRMException& e) {
+                        cerr << "CRM Error: " << e.what() << "\n";
+                    }
+                    catch (const std::exception& e) {
+                        cerr << "Unexpected error: " << e.what() << "\n";
+                    }
                 }
                 else if (choice == 3) {
                     int id = getValidInputNumber<int>("Enter property ID to search: ");
@@ -855,7 +861,7 @@ int main() {
                         existing.setPropertyType(type);
 
                         //We will not allow the user to input bedrooms and bathrooms if the property is land. ~Jad
-                        if (existing.getPropertyType() != "land") {
+                        if (existing.getPropertyType() != PropertyType::Land) {
                             int bedrooms = getValidInputNumber<int>("New number of bedrooms: ");
                             while (bedrooms <0)
                                 {
@@ -868,7 +874,7 @@ int main() {
                         }
 
                         //We will not allow the user to input bedrooms and bathrooms if the property is land. ~Jad
-                        if (existing.getPropertyType() != "land") {
+                        if (existing.getPropertyType() != PropertyType::Land) {
                             int bathrooms = getValidInputNumber<int>("New number of bathrooms: ");
                             while (bathrooms <0){
                                 cout<<"Number of bathrooms should be greater than 0"<<endl;
@@ -904,20 +910,6 @@ int main() {
                         existing.setListingType(listing);
                         
                             if (system.modifyProperty(existing)){
-                                //system.modifyProperty(existing) into the database;
-                                std::stringstream updateQuery;
-                                updateQuery << "UPDATE Properties SET "
-                                            << "SizeSqm = " << existing.getSizeSqm()
-                                            << ", Price = " << existing.getPrice()
-                                            << ", Type = '" << existing.getPropertyType()
-                                            << "', Bedrooms = " << existing.getBedrooms()
-                                            << ", Bathrooms = " << existing.getBathrooms()
-                                            << ", Place = '" << existing.getPlace()
-                                            << "', Available = " << (existing.getAvailability() ? 1 : 0)
-                                            << ", ListingType = '" << existing.getListingType()
-                                            << "' WHERE ID = " << id << ";";
-
-                                db.execute(updateQuery.str());
                                 cout << "Property modified successfully.\n";
                             }else
                                 cout << "Modification failed.\n";
@@ -1009,14 +1001,6 @@ int main() {
 
                     try {
                         system.addContract(ct);
-                        //system.addContract(ct) into the database;
-                        // Inside Add Contract (mainChoice == 4 and choice == 1)
-                        std::stringstream contractQuery;
-                        contractQuery << "INSERT INTO Contracts (PropertyId, ClientId, AgentId, Price, StartDate, EndDate, ContractType, IsActive) VALUES ("
-                                      << propId << ", " << clientId << ", " << agentId << ", " << price << ", '"
-                                      << ct.getStartDate().toString() << "', '" << ct.getEndDate().toString() << "', '"
-                                      << cType << "', " << ct.getIsActive() << ");";
-                        db.execute(contractQuery.str());
                         cout << "Contract added successfully.\n";
                     }
                     catch (const ValidationException& e) {
@@ -1031,13 +1015,18 @@ int main() {
                 }
                 else if (choice == 2) {
                     int id = getValidInputNumber<int>("Enter contract ID to remove: ");
-                    if (system.removeContract(id)){
-                        std::stringstream deleteQuery;
-                        deleteQuery << "DELETE FROM Contracts WHERE ID = " << id << ";";
-                        db.execute(deleteQuery.str());
-                        cout << "Contract removed successfully.\n";
-                    }else
-                        cout << "Contract not found.\n";
+                    try {
+                        if (system.removeContract(id)){
+                            cout << "Contract removed successfully.\n";
+                        }else
+                            cout << "Contract not found.\n";
+                    }
+                    catch (const CRMException& e) {
+                        cerr << "CRM Error: " << e.what() << "\n";
+                    }
+                    catch (const std::exception& e) {
+                        cerr << "Unexpected error: " << e.what() << "\n";
+                    }
                 }
                 else if (choice == 3) {
                     int id = getValidInputNumber<int>("Enter contract ID to search: ");
@@ -1106,20 +1095,6 @@ int main() {
 
 
                         if (system.modifyContract(existing)){
-                            //system.modifyContract(existing) into the database;
-                            std::stringstream updateQuery;
-                            updateQuery << "UPDATE Contracts SET "
-                                        << "PropertyId = " << existing.getPropertyId()
-                                        << ", ClientId = " << existing.getClientId()
-                                        << ", AgentId = " << existing.getAgentId()
-                                        << ", Price = " << existing.getPrice()
-                                        << ", StartDate = '" << existing.getStartDate().toString() << "'"
-                                        << ", EndDate = '" << existing.getEndDate().toString() << "'"
-                                        << ", ContractType = '" << existing.getContractType() << "'"
-                                        << ", IsActive = " << (existing.getIsActive() ? 1 : 0)
-                                        << " WHERE ID = " << id << ";";
-                        
-                            db.execute(updateQuery.str());
                             cout << "Contract modified successfully.\n";
                         }else
                             cout << "Modification failed.\n";
@@ -0,0 +1,93 @@
+// Startup load rate of the CSV data files (CSVTokenizer + CSVRecords
+// parsers behind CRMSystem's loaders).
+//
+//   BenchCsvLoad [rows]
+//
+// For each entity a data file of 'rows' rows (default 1M; contracts get
+// twice that, like the production contracts file) is generated alone in a
+// scratch directory and loaded by constructing CRMSystem, which includes
+// building the ID slots and secondary indexes. The parse column runs just
+// the tokenizer and row parser over the same bytes on one thread; the
+// stringstream column feeds the same parser from the getline/stringstream
+// split it replaced. Build as described in BenchSupport.h.
+
+#include "BenchSupport.h"
+#include "CRMSystem.h"
+#include "CSVTokenizer.h"
+#include "MappedFile.h"
+#include <fstream>
+#include <sstream>
+
+// The pre-tokenizer row split: a stringstream per line, a string per field
+static std::vector<std::string> splitWithStream(const std::string &line) {
+    std::vector<std::string> fields;
+    std::stringstream ss(line);
+    std::string field;
+    while(std::getline(ss, field, ',')) {
+        fields.push_back(field);
+    }
+    return fields;
+}
+
+template <typename T>
+static void run(const char *entity, const char *file, size_t rows, size_t fieldCount,
+                T (*parse)(const std::string_view*), std::vector<T> items) {
+    bench::ScratchDirectory scratch;
+    bench::writeDataFile(file, items);
+    items.clear();
+    items.shrink_to_fit();
+
+    auto start = std::chrono::steady_clock::now();
+    {
+        CRMSystem crm(StorageFormat::CSV);
+        double seconds = bench::secondsSince(start);
+        std::printf("%-9s %8zu   %8.3f s   %10.0f rows/s", entity, rows, seconds, rows / seconds);
+    }
+
+    MappedFile mapped(file);
+    std::string_view text = mapped.contents();
+    std::string_view line;
+    std::string_view fields[CSVRecords::MAX_FIELDS];
+    size_t parsed = 0;
+    start = std::chrono::steady_clock::now();
+    while(CSVTokenizer::nextLine(text, line)) {
+        if(CSVTokenizer::split(line, fields, fieldCount) < fieldCount) continue;
+        T item = parse(fields);
+        parsed += item.getId() > 0;
+    }
+    double parseSeconds = bench::secondsSince(start);
+
+    std::ifstream in(file);
+    std::string row;
+    size_t streamed = 0;
+    start = std::chrono::steady_clock::now();
+    while(std::getline(in, row)) {
+        std::vector<std::string> split = splitWithStream(row);
+        // getline drops a trailing empty field; the rest stay empty views
+        for(size_t i = 0; i < fieldCount; ++i) {
+            fields[i] = i < split.size() ? std::string_view(split[i]) : std::string_view();
+        }
+        T item = parse(fields);
+        streamed += item.getId() > 0;
+    }
+    double streamSeconds = bench::secondsSince(start);
+    if(parsed != rows || streamed != rows)
+        std::cerr << " (row count mismatch: " << parsed << ", " << streamed << ")";
+    std::printf("   %10.0f rows/s   %10.0f rows/s\n", parsed / parseSeconds, streamed / streamSeconds);
+}
+
+int main(int argc, char **argv) {
+    size_t rows = bench::sizeArgument(argc, argv, 1, 1000000);
+
+    std::cout << "entity        rows    CRMSystem load                 parse only   stringstream split"
+              << std::endl;
+    run("agent", "agents_data.csv", rows, CSVRecords::AGENT_FIELDS, CSVRecords::parseAgent,
+        bench::makeRecords<Agent>(rows, bench::makeAgent));
+    run("client", "clients_data.csv", rows, CSVRecords::CLIENT_FIELDS, CSVRecords::parseClient,
+        bench::makeRecords<Client>(rows, bench::makeClient));
+    run("property", "properties_data.csv", rows, CSVRecords::PROPERTY_FIELDS, CSVRecords::parseProperty,
+        bench::makeRecords<Property>(rows, bench::makeProperty));
+    run("contract", "contracts_data.csv", rows * 2, CSVRecords::CONTRACT_FIELDS, CSVRecords::parseContract,
+        bench::makeRecords<Contract>(rows * 2, [](int id, std::mt19937 &rng) { return bench::makeContract(id, rng); }));
+    return 0;
+}
@@ -0,0 +1,128 @@
+// Rows/second written by the CSV save path (CSVRecords::append over
+// CSVWriter) for each entity, against the operator<< path it replaced.
+//
+//   BenchCsvWrite [rows]
+//
+// For each entity, 'rows' records (default 1M) are written four ways in a
+// scratch directory:
+//   format   rows appended to one reused buffer, cleared every 1 MiB (no I/O)
+//   <<       the old formatting: operator<< per field, dates through a
+//            stringstream with setw/setfill, into a std::ostringstream
+//            emptied every 1 MiB (no I/O)
+//   file     the checkpoint path: the 'format' buffer handed to
+//            AtomicFileWriter in 1 MiB writes, then fsync and rename
+//   ofstream the old saver: the '<<' formatting straight into std::ofstream
+// Build as described in BenchSupport.h.
+
+#include "BenchSupport.h"
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+
+static const size_t WRITE_CHUNK_BYTES = 1 << 20;
+
+// The pre-CSVWriter Date::toString
+static std::string dateWithStream(const Date &date) {
+    if(date.isEmpty())
+        return "";
+    std::stringstream ss;
+    ss << std::setw(4) << std::setfill('0') << date.getYear() << "-"
+       << std::setw(2) << std::setfill('0') << date.getMonth() << "-"
+       << std::setw(2) << std::setfill('0') << date.getDay();
+    return ss.str();
+}
+
+static void writeWithStream(std::ostream &out, const Agent &a) {
+    out << a.getId() << "," << a.getFirstName() << "," << a.getLastName() << "," << a.getPhone() << ","
+        << a.getEmail() << "," << dateWithStream(a.getStartDate()) << "," << dateWithStream(a.getEndDate()) << "\n";
+}
+
+static void writeWithStream(std::ostream &out, const Client &c) {
+    out << c.getId() << "," << c.getFirstName() << "," << c.getLastName() << "," << c.getPhone() << ","
+        << c.getEmail() << "," << (c.getIsMarried() ? 1 : 0) << "," << c.getBudget() << ","
+        << toString(c.getBudgetType()) << "\n";
+}
+
+static void writeWithStream(std::ostream &out, const Property &p) {
+    out << p.getId() << "," << p.getSizeSqm() << "," << p.getPrice() << "," << toString(p.getPropertyType()) << ","
+        << p.getBedrooms() << "," << p.getBathrooms() << "," << p.getPlace() << ","
+        << (p.getAvailability() ? 1 : 0) << "," << toString(p.getListingType()) << "\n";
+}
+
+static void writeWithStream(std::ostream &out, const Contract &c) {
+    out << c.getId() << "," << c.getPropertyId() << "," << c.getClientId() << "," << c.getAgentId() << ","
+        << c.getPrice() << "," << dateWithStream(c.getStartDate()) << "," << dateWithStream(c.getEndDate()) << ","
+        << toString(c.getContractType()) << "," << (c.getIsActive() ? 1 : 0) << "\n";
+}
+
+template <typename T>
+static void run(const char *entity, const std::vector<T> &items) {
+    bench::ScratchDirectory scratch;
+    size_t rows = items.size();
+
+    std::string buffer;
+    buffer.reserve(WRITE_CHUNK_BYTES + 4096);
+    size_t bytes = 0;
+    auto start = std::chrono::steady_clock::now();
+    for(const auto &item : items) {
+        CSVRecords::append(buffer, item);
+        buffer += '\n';
+        if(buffer.size() >= WRITE_CHUNK_BYTES) {
+            bytes += buffer.size();
+            buffer.clear();
+        }
+    }
+    bytes += buffer.size();
+    double formatSeconds = bench::secondsSince(start);
+
+    std::ostringstream memory;
+    start = std::chrono::steady_clock::now();
+    for(const auto &item : items) {
+        writeWithStream(memory, item);
+        if(memory.tellp() >= static_cast<std::streamoff>(WRITE_CHUNK_BYTES))
+            memory.str(std::string());
+    }
+    double memorySeconds = bench::secondsSince(start);
+
+    buffer.clear();
+    start = std::chrono::steady_clock::now();
+    {
+        AtomicFileWriter out("data.csv", WRITE_CHUNK_BYTES);
+        for(const auto &item : items) {
+            CSVRecords::append(buffer, item);
+            buffer += '\n';
+            if(buffer.size() >= WRITE_CHUNK_BYTES) {
+                out.write(buffer);
+                buffer.clear();
+            }
+        }
+        out.write(buffer);
+        out.commit();
+    }
+    double fileSeconds = bench::secondsSince(start);
+
+    start = std::chrono::steady_clock::now();
+    {
+        std::ofstream out("legacy.csv");
+        for(const auto &item : items) {
+            writeWithStream(out, item);
+        }
+    }
+    double streamSeconds = bench::secondsSince(start);
+
+    std::printf("%-9s %8zu %6.1f MB  %10.0f  %10.0f  %10.0f  %10.0f\n", entity, rows, bytes / 1e6,
+                rows / formatSeconds, rows / memorySeconds, rows / fileSeconds, rows / streamSeconds);
+}
+
+int main(int argc, char **argv) {
+    size_t rows = bench::sizeArgument(argc, argv, 1, 1000000);
+
+    std::cout << "rows/s           rows     size      format          <<        file    ofstream" << std::endl;
+    run("agent", bench::makeRecords<Agent>(rows, bench::makeAgent));
+    run("client", bench::makeRecords<Client>(rows, bench::makeClient));
+    run("property", bench::makeRecords<Property>(rows, bench::makeProperty));
+    run("contract", bench::makeRecords<Contract>(rows, [](int id, std::mt19937 &rng) {
+        return bench::makeContract(id, rng, 100000);
+    }));
+    return 0;
+}
@@ -0,0 +1,66 @@
+// Point-lookup latency of CRMSystem's ID -> slot indexes as the catalog
+// grows, against the linear scan they replaced.
+//
+//   BenchIdLookup [maxRecords] [lookups]
+//
+// For 1k, 10k, 100k ... up to maxRecords (default 1M) properties and as
+// many contracts, the data files are generated in a scratch directory and
+// loaded through CRMSystem. 'lookups' (default 1M) random IDs, a tenth of
+// them absent, are then resolved with findPropertyById/findContractById.
+// The scan column does a std::find_if over a copy of the properties for
+// 1000 of the same IDs. Build as described in BenchSupport.h.
+
+#include "BenchSupport.h"
+#include "CRMSystem.h"
+#include <algorithm>
+
+int main(int argc, char **argv) {
+    size_t maxRecords = bench::sizeArgument(argc, argv, 1, 1000000);
+    size_t lookups = bench::sizeArgument(argc, argv, 2, 1000000);
+    const size_t SCAN_LOOKUPS = 1000;
+
+    std::cout << "records   property ns/lookup   contract ns/lookup   linear scan ns/lookup" << std::endl;
+    for(size_t records = 1000; records <= maxRecords; records *= 10) {
+        bench::ScratchDirectory scratch;
+        std::vector<Property> properties = bench::makeRecords<Property>(records, bench::makeProperty);
+        bench::writeDataFile("properties_data.csv", properties);
+        bench::writeDataFile("contracts_data.csv", bench::makeRecords<Contract>(records, [](int id, std::mt19937 &rng) {
+            return bench::makeContract(id, rng);
+        }));
+        CRMSystem crm(StorageFormat::CSV);
+
+        // IDs up to 10% past the end, so some lookups miss
+        std::mt19937 rng(7);
+        std::vector<int> ids(lookups);
+        for(int &id : ids) {
+            id = 1 + static_cast<int>(rng() % (records + records / 10));
+        }
+
+        size_t found = 0;
+        auto start = std::chrono::steady_clock::now();
+        for(int id : ids) {
+            found += crm.findPropertyById(id) != nullptr;
+        }
+        double propertyNs = bench::secondsSince(start) * 1e9 / lookups;
+
+        start = std::chrono::steady_clock::now();
+        for(int id : ids) {
+            found += crm.findContractById(id) != nullptr;
+        }
+        double contractNs = bench::secondsSince(start) * 1e9 / lookups;
+
+        size_t scans = std::min(SCAN_LOOKUPS, lookups);
+        start = std::chrono::steady_clock::now();
+        for(size_t i = 0; i < scans; ++i) {
+            int id = ids[i];
+            auto it = std::find_if(properties.begin(), properties.end(),
+                                   [id](const Property &p) { return p.getId() == id; });
+            found += it != properties.end();
+        }
+        double scanNs = bench::secondsSince(start) * 1e9 / scans;
+
+        std::printf("%7zu   %18.1f   %18.1f   %21.1f   (%zu hits)\n",
+                    records, propertyNs, contractNs, scanNs, found);
+    }
+    return 0;
+}
@@ -0,0 +1,72 @@
+// Mass-delete throughput of CRMSystem's removal orders.
+//
+//   BenchMassDelete [maxRecords] [removePercent]
+//
+// For 10k, 100k ... up to maxRecords (default 1M) properties loaded through
+// CRMSystem, removePercent (default 10) percent of them, picked at random,
+// are removed four ways, each on a freshly loaded catalog:
+//   single  one removeProperty call per ID
+//   batch   one removeProperties call for all of them
+// under RemovalOrder::SwapAndPop and RemovalOrder::Stable. Single Stable
+// removals shift the tail every time, so each single run stops after 5 s
+// and reports the rate reached so far.
+//
+// Removals are journaled as in normal use (group commit raised so that
+// fsyncs do not dominate). Journal compactions triggered along the way
+// are reported separately and excluded from the "net" rate. Build as
+// described in BenchSupport.h.
+
+#include "BenchSupport.h"
+#include "CRMSystem.h"
+#include <algorithm>
+
+static const double SINGLE_BUDGET_SECONDS = 5.0;
+
+static void run(size_t records, const std::vector<int> &ids, RemovalOrder order, bool batch) {
+    bench::ScratchDirectory scratch;
+    bench::writeDataFile("properties_data.csv", bench::makeRecords<Property>(records, bench::makeProperty));
+    CRMSystem crm(StorageFormat::CSV);
+    crm.setRemovalOrder(order);
+    crm.setJournalGroupCommit(1 << 20);
+
+    size_t removed = 0;
+    auto start = std::chrono::steady_clock::now();
+    if(batch) {
+        removed = crm.removeProperties(ids);
+    } else {
+        for(int id : ids) {
+            removed += crm.removeProperty(id);
+            if((removed & 63) == 0 && bench::secondsSince(start) > SINGLE_BUDGET_SECONDS)
+                break;
+        }
+    }
+    double seconds = bench::secondsSince(start);
+    double checkpointSeconds = crm.getCheckpointStats().totalDurationMs / 1000;
+    double net = seconds - checkpointSeconds;
+
+    std::printf("%7zu   %-10s  %-6s  %8zu  %9.3f  %12.0f  %9.3f  %12.0f\n",
+                records, order == RemovalOrder::SwapAndPop ? "SwapAndPop" : "Stable", batch ? "batch" : "single",
+                removed, seconds, removed / seconds, checkpointSeconds, net > 0 ? removed / net : 0.0);
+}
+
+int main(int argc, char **argv) {
+    size_t maxRecords = bench::sizeArgument(argc, argv, 1, 1000000);
+    size_t percent = bench::sizeArgument(argc, argv, 2, 10);
+
+    std::cout << "records   order       mode     removed    seconds    removals/s  compaction s  net removals/s"
+              << std::endl;
+    for(size_t records = 10000; records <= maxRecords; records *= 10) {
+        std::vector<int> ids(records);
+        for(size_t i = 0; i < records; ++i) {
+            ids[i] = static_cast<int>(i + 1);
+        }
+        std::shuffle(ids.begin(), ids.end(), std::mt19937(5));
+        ids.resize(records * percent / 100);
+
+        for(RemovalOrder order : {RemovalOrder::SwapAndPop, RemovalOrder::Stable}) {
+            run(records, ids, order, false);
+            run(records, ids, order, true);
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,107 @@
+// Ordered price/size index (PropertyIndex) against a linear scan.
+//
+//   BenchPriceIndex [maxRecords] [queries]
+//
+// For 10k, 100k ... up to maxRecords (default 1M) properties loaded through
+// CRMSystem, each of 'queries' (default 200) random requests is answered
+// three ways by the index and by a scan over a copy of the catalog:
+//   range   price in a random 150k-wide window, size >= 120 sqm
+//   narrow  the same with a 5k-wide price window
+//   top-10  the 10 cheapest available rentals
+// Both sides must return the same number of rows. Build as described in
+// BenchSupport.h.
+
+#include "BenchSupport.h"
+#include "CRMSystem.h"
+#include <algorithm>
+
+struct Timing {
+    double indexUs = 0;
+    double scanUs = 0;
+    size_t rows = 0;
+};
+
+static void printRow(size_t records, const char *query, const Timing &t, size_t queries) {
+    double indexUs = t.indexUs / queries, scanUs = t.scanUs / queries;
+    std::printf("%7zu   %-6s   %12.1f   %12.1f   %7.1fx   %zu rows/query\n",
+                records, query, indexUs, scanUs, scanUs / indexUs, t.rows / queries);
+}
+
+static double microsecondsSince(std::chrono::steady_clock::time_point start) {
+    return bench::secondsSince(start) * 1e6;
+}
+
+int main(int argc, char **argv) {
+    size_t maxRecords = bench::sizeArgument(argc, argv, 1, 1000000);
+    size_t queries = bench::sizeArgument(argc, argv, 2, 200);
+
+    std::cout << "records   query    index us/query    scan us/query   speedup" << std::endl;
+    for(size_t records = 10000; records <= maxRecords; records *= 10) {
+        bench::ScratchDirectory scratch;
+        std::vector<Property> catalog = bench::makeRecords<Property>(records, bench::makeProperty);
+        bench::writeDataFile("properties_data.csv", catalog);
+        CRMSystem crm(StorageFormat::CSV);
+
+        std::mt19937 rng(11);
+        Timing range, narrow, top;
+        for(size_t q = 0; q < queries; ++q) {
+            double low = static_cast<double>(rng() % 900000);
+            for(double width : {150000.0, 5000.0}) {
+                Timing &t = width > 10000 ? range : narrow;
+                PropertyRange bounds;
+                bounds.minPrice = low;
+                bounds.maxPrice = low + width;
+                bounds.minSizeSqm = 120;
+
+                auto start = std::chrono::steady_clock::now();
+                size_t indexed = crm.queryPropertiesInRange(bounds).size();
+                t.indexUs += microsecondsSince(start);
+
+                start = std::chrono::steady_clock::now();
+                std::vector<const Property*> scanned;
+                for(const auto &p : catalog) {
+                    if(p.getPrice() >= *bounds.minPrice && p.getPrice() <= *bounds.maxPrice &&
+                       p.getSizeSqm() >= *bounds.minSizeSqm)
+                        scanned.push_back(&p);
+                }
+                std::sort(scanned.begin(), scanned.end(), [](const Property *a, const Property *b) {
+                    return a->getPrice() < b->getPrice();
+                });
+                t.scanUs += microsecondsSince(start);
+                if(scanned.size() != indexed) {
+                    std::cerr << "Result mismatch: index " << indexed << ", scan " << scanned.size() << std::endl;
+                    return 1;
+                }
+                t.rows += indexed;
+            }
+
+            PropertyQuery rentals;
+            rentals.listingType = ListingType::Rent;
+            rentals.available = true;
+            auto start = std::chrono::steady_clock::now();
+            size_t indexed = crm.cheapestProperties(10, rentals).size();
+            top.indexUs += microsecondsSince(start);
+
+            start = std::chrono::steady_clock::now();
+            std::vector<const Property*> scanned;
+            for(const auto &p : catalog) {
+                if(p.getListingType() == ListingType::Rent && p.getAvailability())
+                    scanned.push_back(&p);
+            }
+            size_t count = std::min<size_t>(10, scanned.size());
+            std::partial_sort(scanned.begin(), scanned.begin() + count, scanned.end(),
+                              [](const Property *a, const Property *b) { return a->getPrice() < b->getPrice(); });
+            scanned.resize(count);
+            top.scanUs += microsecondsSince(start);
+            if(scanned.size() != indexed) {
+                std::cerr << "Result mismatch: index " << indexed << ", scan " << scanned.size() << std::endl;
+                return 1;
+            }
+            top.rows += indexed;
+        }
+        printRow(records, "range", range, queries);
+        printRow(records, "narrow", narrow, queries);
+        printRow(records, "top-10", top, queries);
+    }
+    return 0;
+}
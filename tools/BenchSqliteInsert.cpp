@@ -0,0 +1,74 @@
+// Contract inserts per second into SQLite: autocommit against batched
+// transactions (SQLiteStorage::insertContracts).
+//
+//   BenchSqliteInsert [rows] [autocommitRows] [--db-profile=NAME]
+//
+// Each run starts from a new database in a scratch directory. Autocommit
+// saves 'autocommitRows' (default 300) contracts one SQLiteStorage::save()
+// at a time, each its own transaction; the batched runs insert 'rows'
+// (default 100k) with batch sizes 100, 1000 and 10000. The profile
+// (default "defaults": rollback journal, FULL sync, as DatabaseManager
+// opened every database before DatabaseConfig existed) decides how much
+// each commit costs. Build as described in BenchSupport.h.
+
+#include "BenchSupport.h"
+#include "SQLiteStorage.h"
+#include <cstring>
+
+static const char *DATABASE = "bench.db";
+
+static void report(const char *mode, size_t rows, double seconds) {
+    std::printf("%-20s %8zu rows  %9.3f s  %10.0f rows/s\n", mode, rows, seconds, rows / seconds);
+}
+
+int main(int argc, char **argv) {
+    std::string profile = "defaults";
+    std::vector<char*> sizes{argv[0]};
+    for(int i = 1; i < argc; ++i) {
+        if(std::strncmp(argv[i], "--db-profile=", 13) == 0)
+            profile = argv[i] + 13;
+        else
+            sizes.push_back(argv[i]);
+    }
+    size_t rows = bench::sizeArgument(static_cast<int>(sizes.size()), sizes.data(), 1, 100000);
+    size_t autocommitRows = bench::sizeArgument(static_cast<int>(sizes.size()), sizes.data(), 2, 300);
+
+    try {
+        DatabaseConfig config = DatabaseConfig::fromProfile(profile);
+        std::vector<Contract> contracts = bench::makeRecords<Contract>(rows, [](int id, std::mt19937 &rng) {
+            return bench::makeContract(id, rng);
+        });
+        std::cout << "profile " << profile << " (journal " << config.journalMode << ", synchronous "
+                  << config.synchronous << ")" << std::endl;
+
+        {
+            bench::ScratchDirectory scratch;
+            SQLiteStorage storage(DATABASE, config);
+            size_t count = std::min(autocommitRows, contracts.size());
+            auto start = std::chrono::steady_clock::now();
+            for(size_t i = 0; i < count; ++i) {
+                storage.save(contracts[i]);
+            }
+            report("autocommit", count, bench::secondsSince(start));
+        }
+
+        for(size_t batchSize : {100, 1000, 10000}) {
+            bench::ScratchDirectory scratch;
+            SQLiteStorage storage(DATABASE, config);
+            storage.setBatchSize(batchSize);
+            auto start = std::chrono::steady_clock::now();
+            size_t written = storage.insertContracts(contracts);
+            double seconds = bench::secondsSince(start);
+            std::string mode = "batch size " + std::to_string(batchSize);
+            report(mode.c_str(), written, seconds);
+            if(storage.countRows("contract") != written) {
+                std::cerr << "Row count mismatch after " << mode << std::endl;
+                return 1;
+            }
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 2;
+    }
+    return 0;
+}
@@ -0,0 +1,64 @@
+// Read/write mix throughput under each DatabaseConfig profile.
+//
+//   BenchSqliteProfiles [rows] [seconds] [writePercent]
+//
+// For each profile (defaults, durable, balanced, bulk) a new database in a
+// scratch directory is filled with 'rows' contracts (default 50k) and then
+// hit for 'seconds' (default 3) with random operations: point reads by ID
+// through a cached statement, and writePercent percent (default 10) price
+// updates through SQLiteStorage::save, each its own autocommit
+// transaction. Build as described in BenchSupport.h.
+
+#include "BenchSupport.h"
+#include "SQLiteStorage.h"
+
+int main(int argc, char **argv) {
+    size_t rows = bench::sizeArgument(argc, argv, 1, 50000);
+    double seconds = static_cast<double>(bench::sizeArgument(argc, argv, 2, 3));
+    size_t writePercent = bench::sizeArgument(argc, argv, 3, 10);
+
+    std::vector<Contract> contracts = bench::makeRecords<Contract>(rows, [](int id, std::mt19937 &rng) {
+        return bench::makeContract(id, rng);
+    });
+    std::cout << "profile     journal   sync        ops      reads     writes      ops/s" << std::endl;
+    try {
+        for(const char *profile : {"defaults", "durable", "balanced", "bulk"}) {
+            bench::ScratchDirectory scratch;
+            DatabaseConfig config = DatabaseConfig::fromProfile(profile);
+            SQLiteStorage storage("bench.db", config);
+            storage.insertContracts(contracts);
+
+            std::mt19937 rng(3);
+            size_t reads = 0, writes = 0;
+            double checksum = 0;
+            auto start = std::chrono::steady_clock::now();
+            while(bench::secondsSince(start) < seconds) {
+                // Check the clock every 64 operations
+                for(int i = 0; i < 64; ++i) {
+                    int id = 1 + static_cast<int>(rng() % rows);
+                    if(rng() % 100 < writePercent) {
+                        Contract &contract = contracts[id - 1];
+                        contract.setPrice(contract.getPrice() + 1);
+                        storage.save(contract);
+                        ++writes;
+                    } else {
+                        Statement &read = storage.connection().prepare("SELECT Price FROM Contracts WHERE ID = ?;");
+                        read.bind(1, id);
+                        if(read.step())
+                            checksum += read.getDouble(0);
+                        ++reads;
+                    }
+                }
+            }
+            double elapsed = bench::secondsSince(start);
+            std::printf("%-10s  %-8s  %-6s  %9zu  %9zu  %9zu  %9.0f\n", profile, config.journalMode.c_str(),
+                        config.synchronous.c_str(), reads + writes, reads, writes, (reads + writes) / elapsed);
+            if(checksum < 0)
+                return 1;
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 2;
+    }
+    return 0;
+}
@@ -0,0 +1,113 @@
+// Point reads per second from several threads while one thread writes:
+// SQLiteStorage's pooled read-only connections against sharing the single
+// connection it used to have.
+//
+//   BenchSqliteReaders [rows] [seconds]
+//
+// A new "balanced" (WAL) database in a scratch directory is filled with
+// 'rows' contracts (default 50k). For 1, 2 and 4 reader threads, each mode
+// runs for 'seconds' (default 3) with one writer thread updating random
+// prices through SQLiteStorage::save (one autocommit transaction each) and
+// the readers fetching random prices by ID:
+//   shared  every read and write goes through connection() under one mutex
+//   pool    writes as before, each read checks out a reader() lease
+// Build as described in BenchSupport.h.
+
+#include "BenchSupport.h"
+#include "SQLiteStorage.h"
+#include <atomic>
+#include <mutex>
+#include <thread>
+
+static const char *READ_SQL = "SELECT Price FROM Contracts WHERE ID = ?;";
+
+struct Counts {
+    size_t reads = 0;
+    size_t writes = 0;
+};
+
+static double readPrice(DatabaseManager &db, int id) {
+    Statement &read = db.prepare(READ_SQL);
+    read.bind(1, id);
+    double price = read.step() ? read.getDouble(0) : 0.0;
+    read.reset();
+    return price;
+}
+
+static Counts run(SQLiteStorage &storage, std::vector<Contract> &contracts, size_t readers, double seconds,
+                  bool pooled) {
+    std::mutex shared;
+    std::atomic<bool> stop(false);
+    std::atomic<size_t> reads(0);
+    size_t writes = 0;
+
+    std::vector<std::thread> threads;
+    for(size_t r = 0; r < readers; ++r) {
+        threads.emplace_back([&, r] {
+            std::mt19937 rng(static_cast<unsigned>(r + 1));
+            size_t done = 0;
+            double checksum = 0;
+            while(!stop.load(std::memory_order_relaxed)) {
+                int id = 1 + static_cast<int>(rng() % contracts.size());
+                if(pooled) {
+                    ConnectionPool::Lease reader = storage.reader();
+                    checksum += readPrice(*reader, id);
+                } else {
+                    std::lock_guard<std::mutex> lock(shared);
+                    checksum += readPrice(storage.connection(), id);
+                }
+                ++done;
+            }
+            reads += checksum >= 0 ? done : 0;
+        });
+    }
+
+    std::mt19937 rng(7);
+    auto start = std::chrono::steady_clock::now();
+    while(bench::secondsSince(start) < seconds) {
+        Contract &contract = contracts[rng() % contracts.size()];
+        contract.setPrice(contract.getPrice() + 1);
+        if(pooled) {
+            storage.save(contract);
+        } else {
+            std::lock_guard<std::mutex> lock(shared);
+            storage.save(contract);
+        }
+        ++writes;
+    }
+    stop = true;
+    for(auto &thread : threads) {
+        thread.join();
+    }
+    return {reads.load(), writes};
+}
+
+int main(int argc, char **argv) {
+    size_t rows = bench::sizeArgument(argc, argv, 1, 50000);
+    double seconds = static_cast<double>(bench::sizeArgument(argc, argv, 2, 3));
+
+    std::vector<Contract> contracts = bench::makeRecords<Contract>(rows, [](int id, std::mt19937 &rng) {
+        return bench::makeContract(id, rng);
+    });
+    try {
+        bench::ScratchDirectory scratch;
+        SQLiteStorage storage("bench.db", DatabaseConfig::balanced(), 4);
+        storage.insertContracts(contracts);
+
+        std::cout << "mode    readers      reads/s     writes/s" << std::endl;
+        for(size_t readers : {1, 2, 4}) {
+            for(bool pooled : {false, true}) {
+                Counts counts = run(storage, contracts, readers, seconds, pooled);
+                std::printf("%-6s  %7zu  %11.0f  %11.0f\n", pooled ? "pool" : "shared", readers,
+                            counts.reads / seconds, counts.writes / seconds);
+            }
+        }
+        ConnectionPool::Stats stats = storage.poolStats();
+        std::cout << "reader checkouts " << stats.readerCheckouts << ", waits " << stats.readerWaits
+                  << ", peak in use " << stats.peakReadersInUse << " of " << stats.readers << std::endl;
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 2;
+    }
+    return 0;
+}
@@ -0,0 +1,129 @@
+#ifndef BENCHSUPPORT_H
+#define BENCHSUPPORT_H
+
+// Shared pieces of the tools/Bench*.cpp programs: timing, a throwaway
+// working directory and synthetic records. Each benchmark is a standalone
+// program; build one from the repository root with
+//   g++ -std=gnu++17 -O2 -pthread -I. tools/BenchX.cpp $(ls *.cpp | grep -v main.cpp) -lsqlite3 -o BenchX
+//
+// CRMSystem reads and writes its data files in the working directory, so
+// benchmarks that construct one run inside a ScratchDirectory and never
+// touch the real data.
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <initializer_list>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+#include "AtomicFileWriter.h"
+#include "CSVRecords.h"
+
+namespace bench {
+
+inline double secondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+// Size argument: argv[index] if given, else 'fallback'
+inline size_t sizeArgument(int argc, char **argv, int index, size_t fallback) {
+    return argc > index ? std::strtoul(argv[index], nullptr, 10) : fallback;
+}
+
+// A fresh directory under the system temp directory, made the working
+// directory for the object's lifetime and deleted afterwards
+class ScratchDirectory {
+public:
+    ScratchDirectory() : m_previous(std::filesystem::current_path()) {
+        std::random_device seed;
+        m_path = std::filesystem::temp_directory_path() / ("crm-bench-" + std::to_string(seed()));
+        std::filesystem::create_directories(m_path);
+        std::filesystem::current_path(m_path);
+    }
+    ~ScratchDirectory() {
+        std::error_code ignored;
+        std::filesystem::current_path(m_previous, ignored);
+        std::filesystem::remove_all(m_path, ignored);
+    }
+
+    ScratchDirectory(const ScratchDirectory&) = delete;
+    ScratchDirectory& operator=(const ScratchDirectory&) = delete;
+
+private:
+    std::filesystem::path m_previous;
+    std::filesystem::path m_path;
+};
+
+// Deterministic synthetic records (same seed, same data)
+inline const char* pick(std::mt19937 &rng, std::initializer_list<const char*> options) {
+    return options.begin()[rng() % options.size()];
+}
+
+inline std::string makeDate(std::mt19937 &rng, int firstYear) {
+    char date[11];
+    std::snprintf(date, sizeof date, "%04d-%02d-%02d",
+                  firstYear + static_cast<int>(rng() % 5), 1 + static_cast<int>(rng() % 12),
+                  1 + static_cast<int>(rng() % 28));
+    return date;
+}
+
+inline Agent makeAgent(int id, std::mt19937 &rng) {
+    return Agent(id, pick(rng, {"jad", "rami", "lina", "maya"}), pick(rng, {"Darwish", "Haddad", "Khoury"}),
+                 std::to_string(10000000 + rng() % 89999999), "agent" + std::to_string(id) + "@crm.example",
+                 makeDate(rng, 2015), "");
+}
+
+inline Client makeClient(int id, std::mt19937 &rng) {
+    return Client(id, pick(rng, {"elie", "nour", "karim", "sara"}), pick(rng, {"Saad", "Aoun", "Nassar"}),
+                  std::to_string(10000000 + rng() % 89999999), "client" + std::to_string(id) + "@crm.example",
+                  rng() % 2 == 0, 500 + rng() % 500000, pick(rng, {"rent", "buy"}));
+}
+
+inline Property makeProperty(int id, std::mt19937 &rng) {
+    return Property(id, 40 + rng() % 960, 100 + rng() % 1000000, pick(rng, {"land", "house", "apartment"}),
+                    rng() % 6, rng() % 4, pick(rng, {"beirut", "chouf", "baalbak", "jounieh", "tyre", "zahle"}),
+                    rng() % 4 != 0, pick(rng, {"sale", "rent"}));
+}
+
+// References are drawn from 1..parties; 0 leaves them unset (-1)
+inline Contract makeContract(int id, std::mt19937 &rng, int parties = 0) {
+    auto party = [&] { return parties > 0 ? 1 + static_cast<int>(rng() % parties) : -1; };
+    int propertyId = party();
+    int clientId = party();
+    int agentId = party();
+    std::string start = makeDate(rng, 2018);
+    return Contract(id, propertyId, clientId, agentId, 100 + rng() % 1000000, start, "",
+                    pick(rng, {"sale", "rent"}), rng() % 2 == 0);
+}
+
+// 'make' is called as make(id, rng) for IDs 1..count
+template <typename T, typename Make>
+std::vector<T> makeRecords(size_t count, Make make, unsigned seed = 42) {
+    std::mt19937 rng(seed);
+    std::vector<T> items;
+    items.reserve(count);
+    for(size_t i = 0; i < count; ++i) {
+        items.push_back(make(static_cast<int>(i + 1), rng));
+    }
+    return items;
+}
+
+// Write 'items' as one of CRMSystem's CSV data files
+template <typename T>
+void writeDataFile(const std::string &path, const std::vector<T> &items) {
+    AtomicFileWriter out(path);
+    std::string buffer;
+    for(const auto &item : items) {
+        CSVRecords::append(buffer, item);
+        buffer += '\n';
+    }
+    out.write(buffer);
+    out.commit();
+}
+
+} // namespace bench
+
+#endif // BENCHSUPPORT_H
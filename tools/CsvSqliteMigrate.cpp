@@ -0,0 +1,377 @@
+// Bulk transfer of the CRM data between the CSV data files and SQLite.
+//
+//   CsvSqliteMigrate import [options]   agents/clients/properties/contracts_data.csv -> database
+//   CsvSqliteMigrate export [options]   database -> the four CSV files
+//
+// Options:
+//   --db=PATH           database file (default real_estate.db)
+//   --dir=DIR           directory holding the CSV files (default .)
+//   --batch=ROWS        rows per batch on import (default 10000)
+//   --db-profile=NAME   DatabaseConfig profile (default bulk, see DatabaseConfig.h)
+//   --replace           overwrite a target that already holds data; on export
+//                       also delete CRMSystem's journal and pending save in --dir
+//   --allow-skipped     let an import pass verification although some CSV
+//                       lines could not be parsed (they are still reported)
+//
+// IDs are kept as they are. CSV rows are streamed from a memory-mapped file
+// into batched, prepared upserts; exports stream the tables in ID order into
+// atomically replaced files. Afterwards both sides are read back and compared
+// by row count and by CRC32 over the canonical CSV form of every row
+// (CSVRecords), so a value that does not survive the trip shows up as a
+// checksum mismatch. Data lines that are too short or do not parse are
+// counted, and fail the verification unless --allow-skipped is given.
+// Contract references to rows that do not exist are stored as "none"
+// (-1 / NULL), as the database's foreign keys require.
+//
+// An import runs as one transaction (the batches are savepoints in it) that
+// is only committed once every table has verified, so a failed or rejected
+// import leaves the database as it was.
+//
+// Build from the repository root (all sources but main.cpp):
+//   g++ -std=gnu++17 -O2 -pthread -I. tools/CsvSqliteMigrate.cpp $(ls *.cpp | grep -v main.cpp) -lsqlite3 -o CsvSqliteMigrate
+
+#include "AtomicFileWriter.h"
+#include "BinarySnapshot.h"
+#include "CSVRecords.h"
+#include "CSVTokenizer.h"
+#include "Exceptions.h"
+#include "MappedFile.h"
+#include "SQLiteStorage.h"
+#include "Transaction.h"
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+struct Options {
+    std::string database = "real_estate.db";
+    std::string directory = ".";
+    size_t batchSize = 10000;
+    std::string profile = "bulk";
+    bool replace = false;
+    bool allowSkipped = false;
+};
+
+// CRMSystem's files besides the data files: a journal replayed on startup
+// and the record of a save whose renames were interrupted. Either would be
+// applied on top of freshly exported CSV files.
+static const char *JOURNAL_FILES[] = {"crm_journal.log", "crm_journal.log.1", "crm_data.commit"};
+
+// One data file <-> one table
+template <typename T>
+struct Table {
+    const char *entity;
+    const char *file;
+    size_t fieldCount;
+    T (*parse)(const std::string_view*);
+    size_t (SQLiteStorage::*insert)(const std::vector<T>&);
+    size_t (SQLiteStorage::*scan)(const std::function<void(T&)>&);
+};
+
+static const Table<Agent> AGENTS = {"agent", "agents_data.csv", CSVRecords::AGENT_FIELDS,
+                                    CSVRecords::parseAgent, &SQLiteStorage::insertAgents, &SQLiteStorage::scanAgents};
+static const Table<Client> CLIENTS = {"client", "clients_data.csv", CSVRecords::CLIENT_FIELDS,
+                                      CSVRecords::parseClient, &SQLiteStorage::insertClients, &SQLiteStorage::scanClients};
+static const Table<Property> PROPERTIES = {"property", "properties_data.csv", CSVRecords::PROPERTY_FIELDS,
+                                           CSVRecords::parseProperty, &SQLiteStorage::insertProperties, &SQLiteStorage::scanProperties};
+static const Table<Contract> CONTRACTS = {"contract", "contracts_data.csv", CSVRecords::CONTRACT_FIELDS,
+                                          CSVRecords::parseContract, &SQLiteStorage::insertContracts, &SQLiteStorage::scanContracts};
+
+// Row count and CRC32 over the canonical text of each row, line break
+// included; for a CSV file also the data lines that yielded no row
+struct Digest {
+    size_t rows = 0;
+    uint32_t crc = 0;
+    size_t skipped = 0;
+
+    void add(const std::string &line) {
+        crc = BinarySnapshot::crc32(line.data(), line.size(), crc);
+        ++rows;
+    }
+    bool operator==(const Digest &other) const { return rows == other.rows && crc == other.crc; }
+};
+
+static double secondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+// Prints the outcome; true if the target matches and no line was lost
+static bool report(const char *entity, const Digest &source, double seconds, const Digest &target,
+                   double verifySeconds, bool allowSkipped) {
+    char crc[16];
+    std::snprintf(crc, sizeof crc, "%08x", source.crc);
+    std::cout << entity << ": " << source.rows << " rows in " << seconds << " s ("
+              << static_cast<size_t>(seconds > 0 ? source.rows / seconds : 0) << " rows/s), crc32 " << crc;
+    if(source.skipped > 0)
+        std::cout << ", " << source.skipped << " source line(s) skipped";
+    bool ok = source == target && target.skipped == 0 && (source.skipped == 0 || allowSkipped);
+    if(ok) {
+        std::cout << ", verified in " << verifySeconds << " s" << std::endl;
+    } else if(source == target && target.skipped == 0) {
+        std::cout << ", FAILED: not every source line was transferred (see --allow-skipped)" << std::endl;
+    } else {
+        std::snprintf(crc, sizeof crc, "%08x", target.crc);
+        std::cout << ", MISMATCH: target has " << target.rows << " rows, crc32 " << crc;
+        if(target.skipped > 0)
+            std::cout << ", " << target.skipped << " unreadable line(s)";
+        std::cout << std::endl;
+    }
+    return ok;
+}
+
+// Every well-formed row of a data file, in file order. Short lines are
+// skipped and unparsable ones reported, as CRMSystem does when loading.
+// Returns the number of non-empty lines skipped.
+template <typename T>
+static size_t readDataFile(const Table<T> &table, const std::string &path, const std::function<void(T&)> &visit) {
+    MappedFile file(path);
+    if(!file.isOpen()) {
+        std::cerr << "No " << path << ", nothing to read for " << table.entity << std::endl;
+        return 0;
+    }
+    size_t skipped = 0;
+    std::string_view text = file.contents();
+    std::string_view line;
+    std::string_view fields[CSVRecords::MAX_FIELDS];
+    while(CSVTokenizer::nextLine(text, line)) {
+        if(line.empty()) continue;
+        if(CSVTokenizer::split(line, fields, table.fieldCount) < table.fieldCount) {
+            std::cerr << "Skipping short " << table.entity << " line: " << line << std::endl;
+            ++skipped;
+            continue;
+        }
+        T item;
+        try {
+            item = table.parse(fields);
+        } catch (const std::exception& e) {
+            std::cerr << "Error parsing " << table.entity << ": " << e.what() << std::endl;
+            ++skipped;
+            continue;
+        }
+        visit(item);
+    }
+    return skipped;
+}
+
+template <typename T>
+static Digest digestTable(SQLiteStorage &storage, const Table<T> &table) {
+    Digest digest;
+    std::string line;
+    (storage.*table.scan)([&](T &item) {
+        line.clear();
+        CSVRecords::append(line, item);
+        line += '\n';
+        digest.add(line);
+    });
+    return digest;
+}
+
+template <typename T>
+static Digest digestFile(const Table<T> &table, const std::string &path) {
+    Digest digest;
+    std::string line;
+    digest.skipped = readDataFile<T>(table, path, [&](T &item) {
+        line.clear();
+        CSVRecords::append(line, item);
+        line += '\n';
+        digest.add(line);
+    });
+    return digest;
+}
+
+// ------------------------
+// CSV -> SQLite
+// ------------------------
+// 'fixup' adjusts a row before it is written (and checksummed)
+template <typename T>
+static bool importTable(SQLiteStorage &storage, const Table<T> &table, const Options &options,
+                        std::unordered_set<int> &ids, const std::function<void(T&)> &fixup = nullptr) {
+    std::string path = options.directory + "/" + table.file;
+    auto start = std::chrono::steady_clock::now();
+    Digest source;
+    std::string line;
+    std::vector<T> batch;
+    batch.reserve(options.batchSize);
+    source.skipped = readDataFile<T>(table, path, [&](T &item) {
+        if(fixup)
+            fixup(item);
+        line.clear();
+        CSVRecords::append(line, item);
+        line += '\n';
+        source.add(line);
+        ids.insert(item.getId());
+        batch.push_back(std::move(item));
+        if(batch.size() == options.batchSize) {
+            (storage.*table.insert)(batch);
+            batch.clear();
+        }
+    });
+    (storage.*table.insert)(batch);
+    double seconds = secondsSince(start);
+
+    start = std::chrono::steady_clock::now();
+    Digest target = digestTable(storage, table);
+    return report(table.entity, source, seconds, target, secondsSince(start), options.allowSkipped);
+}
+
+static bool importAll(const Options &options) {
+    SQLiteStorage storage(options.database, DatabaseConfig::fromProfile(options.profile));
+    storage.setBatchSize(options.batchSize);
+    size_t existing = storage.countRows("agent") + storage.countRows("client") +
+                      storage.countRows("property") + storage.countRows("contract");
+    if(existing > 0 && !options.replace)
+        throw ValidationException(options.database + " already holds " + std::to_string(existing) +
+                                  " rows; use --replace to overwrite them");
+
+    // All or nothing: the old rows go and the new ones arrive in one commit
+    Transaction import(storage.connection());
+    if(existing > 0)
+        storage.clear();
+
+    // Parents first, so every contract reference can be checked
+    std::unordered_set<int> agentIds, clientIds, propertyIds, contractIds;
+    bool ok = importTable(storage, AGENTS, options, agentIds);
+    ok = importTable(storage, CLIENTS, options, clientIds) && ok;
+    ok = importTable(storage, PROPERTIES, options, propertyIds) && ok;
+
+    size_t dangling = 0;
+    auto resolve = [&](int id, const std::unordered_set<int> &known) {
+        if(id < 0 || known.count(id))
+            return id;
+        ++dangling;
+        return -1;
+    };
+    ok = importTable<Contract>(storage, CONTRACTS, options, contractIds, [&](Contract &ct) {
+        ct.setPropertyId(resolve(ct.getPropertyId(), propertyIds));
+        ct.setClientId(resolve(ct.getClientId(), clientIds));
+        ct.setAgentId(resolve(ct.getAgentId(), agentIds));
+    }) && ok;
+    if(dangling > 0)
+        std::cout << dangling << " contract reference(s) to missing rows stored as none (-1)" << std::endl;
+    if(!ok) {
+        import.rollback();
+        std::cout << options.database << " left unchanged" << std::endl;
+        return false;
+    }
+    import.commit();
+    return true;
+}
+
+// ------------------------
+// SQLite -> CSV
+// ------------------------
+static const size_t WRITE_CHUNK_BYTES = 1 << 20;
+
+template <typename T>
+static bool exportTable(SQLiteStorage &storage, const Table<T> &table, const Options &options) {
+    std::string path = options.directory + "/" + table.file;
+    auto start = std::chrono::steady_clock::now();
+    Digest source;
+    {
+        AtomicFileWriter out(path);
+        std::string buffer;
+        buffer.reserve(WRITE_CHUNK_BYTES + 4096);
+        (storage.*table.scan)([&](T &item) {
+            size_t begin = buffer.size();
+            CSVRecords::append(buffer, item);
+            buffer += '\n';
+            source.crc = BinarySnapshot::crc32(buffer.data() + begin, buffer.size() - begin, source.crc);
+            ++source.rows;
+            if(buffer.size() >= WRITE_CHUNK_BYTES) {
+                out.write(buffer);
+                buffer.clear();
+            }
+        });
+        out.write(buffer);
+        out.commit();
+    }
+    double seconds = secondsSince(start);
+
+    start = std::chrono::steady_clock::now();
+    Digest target = digestFile(table, path);
+    return report(table.entity, source, seconds, target, secondsSince(start), false);
+}
+
+static bool exportAll(const Options &options) {
+    if(!options.replace) {
+        for(const char *file : {AGENTS.file, CLIENTS.file, PROPERTIES.file, CONTRACTS.file}) {
+            std::string path = options.directory + "/" + file;
+            MappedFile existing(path);
+            if(existing.isOpen() && !existing.contents().empty())
+                throw ValidationException(path + " already holds data; use --replace to overwrite it");
+        }
+    }
+    for(const char *file : JOURNAL_FILES) {
+        std::string path = options.directory + "/" + file;
+        if(!std::filesystem::exists(path))
+            continue;
+        if(!options.replace)
+            throw ValidationException(path + " holds changes CRMSystem would apply on top of the export;"
+                                      " use --replace to discard it");
+        // Before any CSV file changes, so a stale journal never meets the new data
+        std::filesystem::remove(path);
+        std::cout << "Removed " << path << std::endl;
+    }
+    SQLiteStorage storage(options.database, DatabaseConfig::fromProfile(options.profile));
+    bool ok = exportTable(storage, AGENTS, options);
+    ok = exportTable(storage, CLIENTS, options) && ok;
+    ok = exportTable(storage, PROPERTIES, options) && ok;
+    ok = exportTable(storage, CONTRACTS, options) && ok;
+    return ok;
+}
+
+static int usage() {
+    std::cerr << "Usage: CsvSqliteMigrate import|export [--db=PATH] [--dir=DIR] [--batch=ROWS]"
+                 " [--db-profile=NAME] [--replace] [--allow-skipped]" << std::endl;
+    return 2;
+}
+
+int main(int argc, char **argv) {
+    if(argc < 2)
+        return usage();
+    std::string command = argv[1];
+    Options options;
+    for(int i = 2; i < argc; ++i) {
+        std::string arg = argv[i];
+        if(arg.rfind("--db=", 0) == 0) {
+            options.database = arg.substr(5);
+        } else if(arg.rfind("--dir=", 0) == 0) {
+            options.directory = arg.substr(6);
+        } else if(arg.rfind("--batch=", 0) == 0) {
+            options.batchSize = std::strtoul(arg.c_str() + 8, nullptr, 10);
+            if(options.batchSize == 0)
+                options.batchSize = 1;
+        } else if(arg.rfind("--db-profile=", 0) == 0) {
+            options.profile = arg.substr(13);
+        } else if(arg == "--replace") {
+            options.replace = true;
+        } else if(arg == "--allow-skipped") {
+            options.allowSkipped = true;
+        } else {
+            return usage();
+        }
+    }
+
+    try {
+        auto start = std::chrono::steady_clock::now();
+        bool ok;
+        if(command == "import")
+            ok = importAll(options);
+        else if(command == "export")
+            ok = exportAll(options);
+        else
+            return usage();
+        std::cout << (ok ? "Transfer verified" : "Transfer FAILED verification")
+                  << " (" << secondsSince(start) << " s total)" << std::endl;
+        return ok ? 0 : 1;
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 2;
+    }
+}